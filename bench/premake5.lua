@@ -0,0 +1,65 @@
+project "lynx-bench"
+language "C++"
+cppdialect "c++20"
+
+staticruntime "off"
+kind "ConsoleApp"
+
+filter "system:macosx or linux"
+   buildoptions {
+      "-Wall",
+      "-Wextra",
+      "-Wpedantic",
+      "-Wconversion",
+      "-Wno-unused-parameter",
+      "-Wno-sign-conversion",
+      "-Wno-gnu-anonymous-struct",
+      "-Wno-nested-anon-types",
+      "-Wno-string-conversion"
+   }
+filter {}
+
+targetdir("bin/" .. outputdir)
+objdir("build/" .. outputdir)
+
+files {
+   "src/**.cpp",
+   "src/**.hpp"
+}
+
+includedirs {
+   "../include",
+   "%{wks.location}/cpp-kit/include",
+   "%{wks.location}/vendor/spdlog/include",
+   "%{wks.location}/vendor/glfw/include",
+   "%{wks.location}/vendor/glm",
+   "%{wks.location}/vendor/imgui",
+   "%{wks.location}/vendor/imgui/backends",
+   "%{wks.location}/vendor/implot",
+   "%{wks.location}/vendor/yaml-cpp/include"
+}
+
+links {
+   "lynx",
+   "cpp-kit",
+   "glfw",
+   "imgui",
+   "implot",
+   "yaml-cpp"
+}
+
+VULKAN_SDK = os.getenv("VULKAN_SDK")
+filter "system:windows"
+   includedirs "%{VULKAN_SDK}/Include"
+   libdirs "%{VULKAN_SDK}/Lib"
+   links "vulkan-1"
+filter "system:macosx or linux"
+   links "vulkan"
+filter "system:macosx"
+   linkoptions "-rpath %{VULKAN_SDK}/lib"
+   libdirs "%{VULKAN_SDK}/lib"
+   links {
+      "Cocoa.framework",
+      "IOKit.framework",
+      "CoreFoundation.framework"
+   }
@@ -0,0 +1,342 @@
+#include "lynx/app/app.hpp"
+#include "lynx/drawing/shape.hpp"
+#include "lynx/drawing/line.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Drives a headless app through a fixed amount of frames of a synthetic scene and reports frame time percentiles,
+// allocations and gpu time as JSON. Run with a software Vulkan implementation (lavapipe, swiftshader) to compare
+// changes to the render path run to run, or with --null to measure the cpu side alone without any Vulkan driver
+namespace bench
+{
+enum class scene
+{
+    SHAPES,
+    IMMEDIATE,
+    THIN_LINES,
+    LINE_STRIP,
+    CHURN
+};
+
+// Rectangles, ellipses and polygons. The shape scenes hold count shapes of each
+static constexpr std::size_t SHAPE_KINDS = 3;
+
+static constexpr std::array<const char *, 5> SCENE_NAMES = {"shapes", "immediate", "thin_lines", "line_strip",
+                                                             "churn"};
+
+struct options
+{
+    std::vector<scene> scenes;
+    std::uint32_t frames = 600;
+    std::uint32_t warmup = 30;
+    std::uint32_t count = 1000;
+    std::uint32_t dimension = 2;
+    std::uint32_t frames_in_flight = 2;
+    bool null_backend = false;
+    std::string output;
+};
+
+struct result
+{
+    std::string scene;
+    std::uint32_t dimension;
+    std::uint32_t count;
+    std::vector<float> cpu_ms;
+    std::vector<float> gpu_ms;
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t allocated_bytes = 0;
+    std::uint64_t draw_calls = 0;
+};
+
+template <lynx::Dimension Dim> class bench_app final : public lynx::app<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = lynx::window<Dim>;
+
+    bench_app(const scene scn, const std::uint32_t count, const std::uint32_t frames_in_flight, const bool null_backend)
+        : lynx::app<Dim>(typename window_t::specs{"lynx-bench", 1280, 720, true, null_backend,
+                                                  VK_PRESENT_MODE_MAX_ENUM_KHR, 0, frames_in_flight}),
+          m_scene(scn), m_count(count)
+    {
+    }
+
+  private:
+    scene m_scene;
+    std::uint32_t m_count;
+    std::uint32_t m_frame = 0;
+    std::mt19937 m_rng{42};
+    std::size_t m_shapes_added = 0;
+
+    std::vector<kit::scope<lynx::drawable<Dim>>> m_drawables;
+    std::vector<typename Dim::transform_t *> m_transforms;
+    kit::scope<lynx::line_strip<Dim>> m_strip;
+
+    vec_t random_position()
+    {
+        std::uniform_real_distribution<float> dist{-40.f, 40.f};
+        vec_t pos;
+        for (std::size_t i = 0; i < Dim::N; i++)
+            pos[i] = dist(m_rng);
+        return pos;
+    }
+
+    lynx::color random_color()
+    {
+        std::uniform_real_distribution<float> dist{0.f, 1.f};
+        return lynx::color(dist(m_rng), dist(m_rng), dist(m_rng));
+    }
+
+    // Kinds are added round robin and removed first in first out, so that churn keeps the same amount of each
+    void add_shape()
+    {
+        kit::scope<typename Dim::shape_t> shp;
+        switch (m_shapes_added++ % SHAPE_KINDS)
+        {
+        case 0:
+            shp = kit::make_scope<lynx::rect<Dim>>(random_position(), glm::vec2(1.f), random_color());
+            break;
+        case 1:
+            shp = kit::make_scope<lynx::ellipse<Dim>>(0.5f, random_color());
+            break;
+        default:
+            shp = kit::make_scope<lynx::polygon<Dim>>(
+                std::vector<vec_t>{vec_t(-0.5f), vec_t(0.5f), random_position() * 0.02f}, random_color());
+            break;
+        }
+        shp->transform.position = random_position();
+        m_transforms.push_back(&shp->transform);
+        m_drawables.push_back(std::move(shp));
+    }
+
+    void on_start() override
+    {
+        switch (m_scene)
+        {
+        case scene::SHAPES:
+        case scene::CHURN:
+            for (std::size_t i = 0; i < SHAPE_KINDS * m_count; i++)
+                add_shape();
+            break;
+        case scene::THIN_LINES:
+            for (std::size_t i = 0; i < m_count; i++)
+                m_drawables.push_back(
+                    kit::make_scope<lynx::thin_line<Dim>>(random_position(), random_position(), random_color()));
+            break;
+        case scene::LINE_STRIP: {
+            std::vector<vec_t> points(100 * (std::size_t)m_count);
+            for (std::size_t i = 0; i < points.size(); i++)
+                points[i][0] = -40.f + 80.f * (float)i / (float)points.size();
+            m_strip = kit::make_scope<lynx::line_strip<Dim>>(points, random_color());
+            break;
+        }
+        case scene::IMMEDIATE:
+            break;
+        }
+    }
+
+    void on_update(const float ts) override
+    {
+        m_frame++;
+        for (auto *transform : m_transforms)
+            transform->position[0] += 0.01f * std::sin((float)m_frame * 0.05f);
+
+        if (m_scene == scene::LINE_STRIP)
+        {
+            const std::size_t size = 100 * (std::size_t)m_count;
+            for (std::size_t i = 0; i < size; i++)
+                (*m_strip)[i].position[1] = 10.f * std::sin(0.01f * (float)(i + m_frame));
+        }
+        else if (m_scene == scene::CHURN)
+        {
+            // Replace a tenth of the shapes every frame so that models are constantly created and destroyed
+            const std::size_t churn = std::max<std::size_t>(1, m_drawables.size() / 10);
+            m_drawables.erase(m_drawables.begin(), m_drawables.begin() + (std::ptrdiff_t)churn);
+            m_transforms.erase(m_transforms.begin(), m_transforms.begin() + (std::ptrdiff_t)churn);
+            for (std::size_t i = 0; i < churn; i++)
+                add_shape();
+        }
+    }
+
+    void on_render(const float ts) override
+    {
+        window_t &win = *this->window();
+        if (m_scene == scene::IMMEDIATE)
+        {
+            std::vector<lynx::vertex<Dim>> triangle(3);
+            for (std::size_t i = 0; i < m_count; i++)
+            {
+                const vec_t pos = random_position();
+                triangle[0] = {pos, lynx::color::red};
+                triangle[1] = {pos + vec_t(0.5f), lynx::color::green};
+                triangle[2] = {pos - vec_t(0.5f), lynx::color::blue};
+                win.draw(triangle, lynx::topology::TRIANGLE_LIST);
+            }
+            return;
+        }
+        for (const auto &drawable : m_drawables)
+            win.draw(*drawable);
+        if (m_strip)
+            win.draw(*m_strip);
+    }
+};
+
+template <lynx::Dimension Dim> static result run(const scene scn, const options &opts)
+{
+    bench_app<Dim> app{scn, opts.count, opts.frames_in_flight, opts.null_backend};
+    lynx::window<Dim> &win = *app.window();
+    if (!opts.null_backend)
+        win.renderer().enable_gpu_profiling();
+
+    result res{SCENE_NAMES[(std::size_t)scn], opts.dimension, opts.count, {}, {}};
+    res.cpu_ms.reserve(opts.frames);
+    res.gpu_ms.reserve(opts.frames);
+
+    app.start();
+    for (std::uint32_t i = 0; i < opts.warmup + opts.frames; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        app.next_frame();
+        const auto end = std::chrono::steady_clock::now();
+        if (i < opts.warmup)
+            continue;
+
+        res.cpu_ms.push_back(std::chrono::duration<float, std::milli>(end - start).count());
+        const lynx::render_stats &stats = win.render_stats();
+        if (!opts.null_backend)
+            res.gpu_ms.push_back(stats.gpu_milliseconds);
+
+        res.allocations += stats.allocations;
+        res.frees += stats.frees;
+        res.allocated_bytes += stats.allocated_bytes;
+        res.draw_calls += stats.draw_calls;
+    }
+    app.shutdown();
+    return res;
+}
+
+static float percentile(std::vector<float> values, const float p)
+{
+    if (values.empty())
+        return 0.f;
+    std::sort(values.begin(), values.end());
+    const std::size_t index = (std::size_t)(p * (float)(values.size() - 1) + 0.5f);
+    return values[index];
+}
+
+static void write_percentiles(std::ostream &out, const char *name, const std::vector<float> &values)
+{
+    out << "\"" << name << "\": {\"p50\": " << percentile(values, 0.5f) << ", \"p90\": " << percentile(values, 0.9f)
+        << ", \"p99\": " << percentile(values, 0.99f) << ", \"max\": " << percentile(values, 1.f) << "}";
+}
+
+static void write_json(std::ostream &out, const std::vector<result> &results)
+{
+    out << "[\n";
+    for (std::size_t i = 0; i < results.size(); i++)
+    {
+        const result &res = results[i];
+        const float frames = (float)std::max<std::size_t>(1, res.cpu_ms.size());
+        out << "  {\"scene\": \"" << res.scene << "\", \"dimension\": " << res.dimension
+            << ", \"count\": " << res.count << ", \"frames\": " << res.cpu_ms.size() << ", ";
+        write_percentiles(out, "cpu_ms", res.cpu_ms);
+        out << ", ";
+        write_percentiles(out, "gpu_ms", res.gpu_ms);
+        out << ", \"allocations_per_frame\": " << (float)res.allocations / frames
+            << ", \"frees_per_frame\": " << (float)res.frees / frames
+            << ", \"allocated_bytes_per_frame\": " << (float)res.allocated_bytes / frames
+            << ", \"draw_calls_per_frame\": " << (float)res.draw_calls / frames << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+static void print_usage()
+{
+    std::cout << "Usage: lynx-bench [--scene shapes|immediate|thin_lines|line_strip|churn|all] [--frames N] "
+                 "[--warmup N] [--count K] [--dim 2|3] [--frames-in-flight 1-3] [--null] "
+                 "[--output path]\n"
+                 "  --count K: shapes of each kind, triangles, thin lines or hundreds of strip points, depending on "
+                 "the scene\n";
+}
+
+static bool parse(const int argc, char **argv, options &opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        if (std::strcmp(arg, "--null") == 0)
+        {
+            opts.null_backend = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--help") == 0 || i + 1 == argc)
+            return false;
+
+        const char *value = argv[++i];
+        if (std::strcmp(arg, "--scene") == 0)
+        {
+            if (std::strcmp(value, "all") == 0)
+                continue;
+            const auto it = std::find_if(SCENE_NAMES.begin(), SCENE_NAMES.end(),
+                                         [value](const char *name) { return std::strcmp(name, value) == 0; });
+            if (it == SCENE_NAMES.end())
+                return false;
+            opts.scenes.push_back((scene)(it - SCENE_NAMES.begin()));
+        }
+        else if (std::strcmp(arg, "--frames") == 0)
+            opts.frames = (std::uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--warmup") == 0)
+            opts.warmup = (std::uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--count") == 0)
+            opts.count = (std::uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--dim") == 0)
+            opts.dimension = (std::uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--frames-in-flight") == 0)
+            opts.frames_in_flight = (std::uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--output") == 0)
+            opts.output = value;
+        else
+            return false;
+    }
+    return (opts.dimension == 2 || opts.dimension == 3) && opts.frames_in_flight >= 1 &&
+           opts.frames_in_flight <= lynx::swap_chain::MAX_FRAMES_IN_FLIGHT;
+}
+} // namespace bench
+
+int main(int argc, char **argv)
+{
+    bench::options opts;
+    if (!bench::parse(argc, argv, opts))
+    {
+        bench::print_usage();
+        return EXIT_FAILURE;
+    }
+    if (opts.scenes.empty())
+        for (std::size_t i = 0; i < bench::SCENE_NAMES.size(); i++)
+            opts.scenes.push_back((bench::scene)i);
+
+    std::vector<bench::result> results;
+    for (const bench::scene scn : opts.scenes)
+        results.push_back(opts.dimension == 2 ? bench::run<lynx::dimension::two>(scn, opts)
+                                              : bench::run<lynx::dimension::three>(scn, opts));
+
+    if (opts.output.empty())
+        bench::write_json(std::cout, results);
+    else
+    {
+        std::ofstream file{opts.output, std::ios::trunc};
+        bench::write_json(file, results);
+    }
+    return EXIT_SUCCESS;
+}
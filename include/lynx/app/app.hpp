@@ -2,12 +2,17 @@
 
 #include "lynx/app/window.hpp"
 #include "lynx/app/layer.hpp"
+#include "lynx/app/frame_pacer.hpp"
+#include "lynx/multithreading/job_system.hpp"
 #include "lynx/internal/context.hpp"
 #include "lynx/internal/dimension.hpp"
 #include "kit/profiling/clock.hpp"
 #include "kit/serialization/yaml/serializer.hpp"
 #include "kit/utility/type_constraints.hpp"
 
+#include <atomic>
+#include <thread>
+
 #ifdef LYNX_ENABLE_IMGUI
 #include <imgui.h>
 #ifdef LYNX_ENABLE_IMPLOT
@@ -51,6 +56,10 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     const window_t *window() const;
     window_t *window();
 
+    // Thread pool shared by the app, its layers and its window. Scratch arenas are reset at the start of every frame
+    const job_system &jobs() const;
+    job_system &jobs();
+
     kit::perf::time frame_time() const;
     kit::perf::time update_time() const;
     kit::perf::time render_time() const;
@@ -74,9 +83,60 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     std::uint32_t framerate_cap() const;
     void limit_framerate(std::uint32_t framerate);
 
+    const frame_pacer &pacer() const;
+    frame_pacer &pacer();
+    // Feeds the pacer the time each frame finished presenting (see frame_pacer::align)
+    void align_to_presentation(bool align = true);
+
+    // A non zero fixed timestep runs on_fixed_update as many times per frame as whole steps fit in the accumulated frame
+    // time, at most max_steps times. Time beyond that is dropped, so that a slow frame cannot snowball into ever more
+    // steps. The leftover fraction of a step is exposed as an interpolation alpha between the last two simulated
+    // states, for rendering at a rate that does not match the simulation's
+    void fixed_timestep(float seconds, std::uint32_t max_steps = 8);
+    float fixed_timestep() const;
+    float interpolation_alpha() const;
+
+    // In fast forward mode frames are not paced and only some of them are presented: those at least 1 / present_rate
+    // seconds after the last presented one, or every present_interval frames (either limit is ignored when 0, and
+    // every frame is presented when both are). The rest run events and updates only, without rendering, ImGui, command
+    // recording or render system work. Window events are only polled on presented frames
+    void fast_forward(bool enabled, std::uint32_t present_rate = 30, std::uint32_t present_interval = 0);
+    bool fast_forward() const;
+
+    // In idle mode, each frame first blocks waiting for window events until there is input, a pending redraw request or
+    // the timeout expires (0 waits indefinitely), unless the app is animating. Ignored by headless windows
+    void idle_mode(bool enabled, float timeout_seconds = 0.f);
+    bool idle_mode() const;
+    // Makes sure at least the given amount of frames are drawn, waking the app up if it is idle. Thread safe
+    void request_redraw(std::uint32_t frames = 1);
+    // While animating, idle mode draws continuously
+    void animating(bool animating);
+    bool animating() const;
+
+    // Moves command recording and presentation to a render thread, so that events, updates and drawing are not held back
+    // by fence waits or vsync. Each frame publishes its render data (see window::threaded_rendering) and the render
+    // thread renders the latest published one, dropping those it could not keep up with. Layers' command submissions
+    // then run on the render thread and are not timed. ImGui draw data is copied into each published frame, and ImGui
+    // viewports are not rendered. Layers cannot be pushed or popped meanwhile. Must be toggled between frames
+    void threaded_rendering(bool enabled);
+    bool threaded_rendering() const;
+
+    // Runs the fixed and variable updates of layers that do not conflict (see layer::reads) concurrently on the job
+    // system. Conflicting layers still update in their relative order, and the app's own updates run before and after
+    // all of them. Layers that draw from their updates must declare it (see layer::DRAWING). While disabled, which is
+    // the default, layers update sequentially in order
+    void parallel_updates(bool enabled);
+    bool parallel_updates() const;
+
+    // Times every layer callback. Costs a branch per callback while disabled
+    void enable_layer_timing(bool enabled = true);
+    bool layer_timing_enabled() const;
+    const layer_timings &layer_timing(const std::string &name) const;
+
     template <kit::DerivedFrom<layer_t> L, class... Args> L *push_layer(Args &&...args)
     {
         KIT_ASSERT_ERROR(!m_terminated, "Cannot push layers to a terminated app")
+        KIT_ASSERT_ERROR(!m_render_thread.joinable(), "Cannot push layers while rendering is threaded")
 
         context_t::set(m_window.get());
         auto ly = kit::make_scope<L>(std::forward<Args>(args)...);
@@ -96,6 +156,7 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     template <kit::DerivedFrom<layer_t> L = layer_t> kit::scope<L> pop_layer(const std::string &name)
     {
         KIT_ASSERT_ERROR(!m_terminated, "Cannot pop layers to a terminated app")
+        KIT_ASSERT_ERROR(!m_render_thread.joinable(), "Cannot pop layers while rendering is threaded")
 
         context_t::set(m_window.get());
 
@@ -132,21 +193,54 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     bool m_ongoing_frame = false;
 
     std::vector<kit::scope<layer_t>> m_layers;
+    job_system m_jobs;
     kit::scope<window_t> m_window;
     kit::perf::time m_frame_time;
     kit::perf::time m_update_time;
     kit::perf::time m_render_time;
 
-    kit::perf::time m_min_frame_time;
+    frame_pacer m_pacer;
+    frame_pacer::clock::time_point m_last_frame_start{};
+    bool m_align_to_presentation = false;
+    bool m_layer_timing = false;
+    bool m_parallel_updates = false;
+
+    float m_fixed_timestep = 0.f;
+    float m_accumulator = 0.f;
+    std::uint32_t m_max_fixed_steps = 8;
+
+    bool m_fast_forward = false;
+    std::uint32_t m_present_rate = 30;
+    std::uint32_t m_present_interval = 0;
+    std::uint32_t m_frames_since_present = 0;
+    frame_pacer::clock::time_point m_last_present{};
+
+    bool m_idle_mode = false;
+    bool m_animating = false;
+    float m_idle_timeout = 0.f;
+    std::atomic<std::uint32_t> m_redraw_frames{0};
 
     state m_state = state::NONE;
+    std::thread m_render_thread;
 
 #ifdef LYNX_ENABLE_IMGUI
+    // Deep copy of ImGui's draw data, so that a published frame can be rendered while the next one is being built
+    struct imgui_snapshot : kit::non_copyable
+    {
+        ImDrawData data;
+        ImVector<ImDrawList *> lists;
+
+        ~imgui_snapshot();
+        void capture(const ImDrawData *source);
+        void clear();
+    };
+
     VkDescriptorPool m_imgui_pool;
     ImGuiContext *m_imgui_context;
 #ifdef LYNX_ENABLE_IMPLOT
     ImPlotContext *m_implot_context;
 #endif
+    std::array<imgui_snapshot, frame_handoff::SLOTS> m_imgui_snapshots;
 #endif
 
     virtual void on_start()
@@ -155,6 +249,9 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     virtual void on_late_start()
     {
     }
+    virtual void on_fixed_update(float ts)
+    {
+    }
     virtual void on_update(float ts)
     {
     }
@@ -181,6 +278,28 @@ template <Dimension Dim> class app : kit::non_copyable, public kit::yaml::serial
     {
     }
 
+    bool wait_for_redraw();
+    bool should_present();
+    void render_frame(float ts);
+    void submit_commands(VkCommandBuffer command_buffer);
+    void render_loop();
+    void start_render_thread();
+    void stop_render_thread();
+    void schedule_redraw(std::uint32_t frames);
+    void update_layers(const std::function<void(layer_t &)> &update);
+
+    template <class F> void time_layer(layer_timings::phase &phase, F &&callback)
+    {
+        if (!m_layer_timing) [[likely]]
+        {
+            callback();
+            return;
+        }
+        const kit::perf::clock clock;
+        callback();
+        phase.add(clock.elapsed().as<kit::perf::time::milliseconds, float>());
+    }
+
 #ifdef LYNX_ENABLE_IMGUI
     void imgui_init();
     void imgui_begin_render();
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace lynx
+{
+// Lock free triple buffer of slot indices between a producer thread, which records frames, and a consumer thread,
+// which renders them. The producer always owns a slot to record into and the consumer one to render from, while the
+// third holds the latest complete frame. Publishing and acquiring swap a slot with that one atomically, keeping the
+// stop bit, so neither thread ever waits on the other: if the producer is faster, unconsumed frames are overwritten by
+// newer ones and counted as dropped
+class frame_handoff
+{
+  public:
+    static inline constexpr std::uint32_t SLOTS = 3;
+
+    std::uint32_t record_slot() const;
+    std::uint32_t render_slot() const;
+
+    // Producer side. Hands the record slot over as the latest frame and returns the slot to record the next one into
+    std::uint32_t publish();
+
+    // Consumer side. Blocks until a frame is published and switches the render slot to it. Returns false if stopped
+    bool acquire();
+
+    // Wakes the consumer up and makes every following acquire fail until reset
+    void stop();
+    void reset();
+
+    std::uint64_t published_frames() const;
+    std::uint64_t dropped_frames() const;
+
+  private:
+    static inline constexpr std::uint32_t SLOT_MASK = 0x3;
+    static inline constexpr std::uint32_t FRESH = 0x4;
+    static inline constexpr std::uint32_t STOPPED = 0x8;
+
+    std::atomic<std::uint32_t> m_latest{1};
+    std::uint32_t m_record_slot = 0;
+    std::uint32_t m_render_slot = 2;
+
+    std::atomic<std::uint64_t> m_published_frames{0};
+    std::atomic<std::uint64_t> m_dropped_frames{0};
+};
+} // namespace lynx
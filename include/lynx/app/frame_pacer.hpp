@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace lynx
+{
+// Paces frames against absolute deadlines instead of sleeping for the time left over by the previous frame. It sleeps
+// until shortly before the deadline, where OS timers are still reliable, and spins the remaining tail. Deadlines
+// advance by exactly one period, so a late wake up is absorbed by the next frame rather than accumulating as drift. A
+// frame that overruns its deadline counts as missed; if it overruns by more than a whole period, the schedule restarts
+// from the current time instead of rushing through the backlog
+class frame_pacer
+{
+  public:
+    using clock = std::chrono::steady_clock;
+
+    frame_pacer(std::uint32_t framerate = 0);
+
+    // Blocks until the next deadline and returns the time the frame starts at. Does not block if uncapped
+    clock::time_point wait();
+
+    // Feeds the time a frame was presented at, so that the next deadline is placed one period after it minus the
+    // average time between a frame's start and its presentation. Only meaningful when presentation is synchronized
+    void align(clock::time_point presented);
+    // Restarts the schedule at the next wait without counting the gap as a missed deadline, for when frames were paused
+    // on purpose
+    void reset();
+
+    std::uint32_t framerate() const;
+    void framerate(std::uint32_t framerate);
+
+    clock::duration spin_threshold() const;
+    void spin_threshold(clock::duration threshold);
+
+    std::uint64_t missed_deadlines() const;
+    // How late the last frame started with respect to its deadline
+    clock::duration last_lateness() const;
+
+  private:
+    clock::duration m_period{0};
+    clock::duration m_spin_threshold = std::chrono::microseconds(1500);
+    clock::time_point m_deadline{};
+    clock::time_point m_frame_start{};
+    clock::duration m_present_latency{0};
+
+    std::uint64_t m_missed_deadlines = 0;
+    clock::duration m_last_lateness{0};
+};
+} // namespace lynx
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "lynx/app/input.hpp"
+#include "lynx/multithreading/job_system.hpp"
 #include "lynx/internal/dimension.hpp"
 #include "kit/interface/identifiable.hpp"
 #include "kit/interface/toggleable.hpp"
@@ -8,12 +9,46 @@
 #include "kit/utility/type_constraints.hpp"
 
 #include <functional>
+#include <string>
+#include <array>
+#include <vector>
 #include <vulkan/vulkan.hpp>
 
 namespace lynx
 {
 template <Dimension Dim> class app;
 
+// Rolling per phase times of a layer in milliseconds, only gathered while the app has layer timing enabled. Events and
+// command submissions are summed over the frame, and so are fixed updates, which count towards the update phase
+struct layer_timings
+{
+    static inline constexpr std::size_t SAMPLES = 64;
+
+    class phase
+    {
+      public:
+        void add(float milliseconds);
+        void commit();
+
+        float last() const;
+        float average() const;
+        float max() const;
+
+      private:
+        std::array<float, SAMPLES> m_samples{};
+        std::size_t m_head = 0;
+        std::size_t m_size = 0;
+        float m_accumulated = 0.f;
+    };
+
+    phase update;
+    phase render;
+    phase event;
+    phase submission;
+
+    void commit();
+};
+
 template <Dimension Dim>
 class layer : public kit::identifiable<std::string>,
               public kit::toggleable,
@@ -35,6 +70,22 @@ class layer : public kit::identifiable<std::string>,
 
     KIT_TOGGLEABLE_FINAL_DEFAULT_SETTER()
 
+    const layer_timings &timings() const;
+    // See app::request_redraw. The layer must be attached to an app
+    void request_redraw(std::uint32_t frames = 1) const;
+    // The app's thread pool. The layer must be attached to an app
+    job_system &jobs() const;
+
+    // Declares the shared state the layer's updates read and write, by name, so that the app can run the updates of
+    // layers that do not conflict concurrently (see app::parallel_updates). Every layer implicitly writes its own id,
+    // so reading another layer's id orders it after that layer. A layer declaring nothing conflicts with every other.
+    // The window's render data is not thread safe: a layer that draws from its updates must write DRAWING
+    static inline constexpr const char *DRAWING = "lynx::drawing";
+
+    void reads(const std::string &resource);
+    void writes(const std::string &resource);
+    bool conflicts_with(const layer &other) const;
+
 #ifdef KIT_USE_YAML_CPP
     virtual YAML::Node encode() const override;
     virtual bool decode(const YAML::Node &node) override;
@@ -42,6 +93,12 @@ class layer : public kit::identifiable<std::string>,
 
   private:
     app_t *m_parent = nullptr;
+    layer_timings m_timings;
+    std::vector<std::string> m_reads;
+    std::vector<std::string> m_writes;
+
+    bool declares_access() const;
+    bool writes_to(const std::string &resource) const;
 
     virtual void on_attach()
     {
@@ -52,6 +109,9 @@ class layer : public kit::identifiable<std::string>,
     virtual void on_start()
     {
     }
+    virtual void on_fixed_update(float ts)
+    {
+    }
     virtual void on_update(float ts)
     {
     }
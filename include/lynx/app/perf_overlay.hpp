@@ -0,0 +1,63 @@
+#pragma once
+
+#ifdef LYNX_ENABLE_IMGUI
+#include "lynx/app/layer.hpp"
+
+#include <array>
+#include <string>
+
+namespace lynx
+{
+// Samples the app's frame, update, render and gpu times into fixed size rings every frame and shows them in an ImGui
+// window, together with the window's render stats, the device memory in use and a few live controls. Sampling is a
+// handful of stores per frame; the percentiles are only computed while the window is drawn
+template <Dimension Dim> class perf_overlay : public layer<Dim>
+{
+  public:
+    static inline constexpr std::size_t SAMPLES = 256;
+
+    perf_overlay(const std::string &name = "Performance");
+
+    class ring
+    {
+      public:
+        void push(float value);
+
+        float percentile(float p) const;
+        float average() const;
+        float last() const;
+
+        const float *data() const;
+        std::size_t size() const;
+        std::size_t offset() const;
+
+      private:
+        std::array<float, SAMPLES> m_values{};
+        std::size_t m_head = 0;
+        std::size_t m_size = 0;
+    };
+
+    const ring &frame_ring() const;
+    const ring &update_ring() const;
+    const ring &render_ring() const;
+    const ring &gpu_ring() const;
+
+  private:
+    ring m_frame;
+    ring m_update;
+    ring m_render;
+    ring m_gpu;
+
+    void on_render(float ts) override;
+
+    void draw_timings() const;
+    void draw_layer_timings() const;
+    void draw_render_stats() const;
+    void draw_controls();
+    void draw_renderer_controls();
+};
+
+using perf_overlay2D = perf_overlay<dimension::two>;
+using perf_overlay3D = perf_overlay<dimension::three>;
+} // namespace lynx
+#endif
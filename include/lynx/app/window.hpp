@@ -3,11 +3,15 @@
 #include "lynx/rendering/render_system.hpp"
 #include "lynx/rendering/renderer.hpp"
 #include "lynx/rendering/swap_chain.hpp"
+#include "lynx/rendering/render_stats.hpp"
 #include "lynx/app/input.hpp"
+#include "lynx/app/frame_handoff.hpp"
+#include "lynx/multithreading/job_system.hpp"
 #include "lynx/drawing/drawable.hpp"
 #include "lynx/drawing/color.hpp"
 #include "lynx/geometry/camera.hpp"
 #include "lynx/internal/context.hpp"
+#include "lynx/profiling/trace.hpp"
 #include "kit/memory/ptr/ref.hpp"
 #include "kit/memory/ptr/scope.hpp"
 #include "kit/interface/nameable.hpp"
@@ -17,6 +21,9 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <thread>
 #include <vulkan/vulkan.hpp>
 #include <queue>
 
@@ -41,6 +48,13 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
         const char *name = "Lynx window";
         std::uint32_t width = 800;
         std::uint32_t height = 600;
+        bool headless = false; // Render offscreen without creating a GLFW window or a surface
+        // Implies headless. Skips Vulkan entirely and only exercises the cpu side of rendering
+        bool null_backend = false;
+        // Swap chain configuration (see swap_chain::config_info). It can be changed later with renderer().reconfigure()
+        VkPresentModeKHR present_mode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+        std::uint32_t image_count = 0;
+        std::uint32_t frames_in_flight = 2;
     };
 
     window(const specs &spc);
@@ -61,27 +75,41 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
 
     template <kit::Callable<VkCommandBuffer> F> bool display(F submission = [](VkCommandBuffer) {})
     {
-        KIT_PERF_SCOPE("lynx::window::display")
+        LYNX_TRACE_SCOPE("lynx::window::display")
         if (VkCommandBuffer command_buffer = m_renderer->begin_frame())
         {
-            if (m_maintain_camera_aspect_ratio)
-                m_camera->keep_aspect_ratio(m_renderer->swap_chain().extent_aspect_ratio());
-            m_camera->update_transformation_matrices();
-
+            if (m_threaded_rendering)
+                m_swap_chain_aspect.store(m_renderer->swap_chain().extent_aspect_ratio(), std::memory_order_relaxed);
+            else
+            {
+                if (m_maintain_camera_aspect_ratio)
+                    m_camera->keep_aspect_ratio(m_renderer->swap_chain().extent_aspect_ratio());
+                m_camera->update_transformation_matrices();
+            }
+
+            dispatch(command_buffer);
             m_renderer->begin_swap_chain_render_pass(command_buffer, background_color);
             render(command_buffer);
+            m_renderer->composite_scene(command_buffer);
             submission(command_buffer);
 
             m_renderer->end_swap_chain_render_pass(command_buffer);
             m_renderer->end_frame();
 
-            clear_render_data();
+            collect_stats();
+            if (!m_threaded_rendering)
+                clear_render_data();
             return true;
         }
+        // The frame is skipped, for instance while the window is minimized, but its render data must not pile up
+        if (!m_threaded_rendering)
+            clear_render_data();
         return false;
     }
 
     bool should_close() const;
+    bool headless() const;
+    bool null_backend() const;
     bool closed();
     void close();
     void wait_for_device() const;
@@ -107,14 +135,44 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
     void push_event(const event_t &ev);
     event_t poll_event();
 
+    lynx::render_stats render_stats() const;
+    void record_stats_history(std::size_t capacity = 600);
+    void stop_stats_history();
+    bool recording_stats_history() const;
+    // A copy taken under the stats lock, as the rendering thread may be pushing to the history
+    render_stats_history stats_history() const;
+
     const renderer_t &renderer() const;
+    renderer_t &renderer();
     const kit::ref<const lynx::device> &device() const;
 
+    // Thread pool of the app owning the window, if any
+    job_system *jobs() const;
+    void jobs(job_system *jobs);
+
     void draw(const std::vector<vertex_t> &vertices, topology tplg, const transform_t &transform = {});
     void draw(const std::vector<vertex_t> &vertices, const std::vector<std::uint32_t> &indices, topology tplg,
               const transform_t &transform = {});
     void draw(const drawable_t &drawable);
 
+    // While suspended, draw calls made through the window are dropped. Meant for frames that will not be presented
+    void suspend_drawing(bool suspend);
+    bool drawing_suspended() const;
+    // Drops everything drawn since the last display without rendering it
+    void discard_frame();
+
+    // Splits drawing and rendering across two threads. Drawing records into a slot of its own, and publish_frame hands
+    // it over along with a snapshot of the camera. The render thread waits for frames with acquire_frame and renders
+    // the latest one with display, while the next is already being drawn (see frame_handoff). Models referenced by a
+    // published frame must not be modified until it is rendered, and the renderer must not be reconfigured from the
+    // drawing thread meanwhile. Must be toggled while no frame is being rendered
+    void threaded_rendering(bool enabled);
+    bool threaded_rendering() const;
+    void publish_frame();
+    bool acquire_frame();
+    const frame_handoff &handoff() const;
+    frame_handoff &handoff();
+
     template <kit::DerivedFrom<camera_t> T = camera_t> const T *camera() const
     {
         return kit::get_casted_raw_ptr<const T>(m_camera);
@@ -138,6 +196,7 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
     template <kit::DerivedFrom<render_system_t> T, class... Args> T *add_render_system(Args &&...args)
     {
         KIT_ASSERT_ERROR(!get_render_system<T>(), "A system with the provided type already exists")
+        KIT_ASSERT_ERROR(!m_threaded_rendering, "Cannot add render systems while rendering is threaded")
 
         auto system = kit::make_scope<T>(std::forward<Args>(args)...);
         T *ptr = system.get();
@@ -158,7 +217,7 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
         return nullptr;
     }
 
-    template <kit::DerivedFrom<render_system_t> T, typename B> T *get_render_system()
+    template <kit::DerivedFrom<render_system_t> T> T *get_render_system()
     {
         for (const auto &rs : m_render_systems)
         {
@@ -174,8 +233,13 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
     void clear_render_data();
 
   private:
-    std::uint32_t m_width, m_height;
-    GLFWwindow *m_window;
+    // Written by the resize callback and read by the renderer, which may live on the render thread. Both halves are
+    // packed together so that a reader never sees the width of one resize with the height of another
+    std::atomic<std::uint64_t> m_extent;
+    GLFWwindow *m_window = nullptr;
+    bool m_headless;
+    bool m_null_backend;
+    bool m_headless_closed = false;
 
     kit::ref<const lynx::device> m_device;
     kit::scope<renderer_t> m_renderer;
@@ -183,10 +247,46 @@ template <Dimension Dim> class window : kit::non_copyable, public kit::nameable<
     std::queue<event_t> m_event_queue;
     std::vector<kit::scope<render_system_t>> m_render_systems;
 
-    bool m_resized = false;
+    // Frozen copy of the camera as it was when a frame was published
+    class camera_snapshot final : public camera_t
+    {
+      public:
+        void capture(const camera_t &cam)
+        {
+            this->transform = cam.transform;
+            this->m_projection = cam.projection();
+            this->m_inv_projection = cam.inverse_projection();
+        }
+        void update_transformation_matrices() override
+        {
+        }
+    };
+
+    std::atomic<bool> m_resized = false;
+    bool m_drawing_suspended = false;
+#ifdef DEBUG
+    // The thread currently drawing, to catch layers that draw concurrently from parallel updates (see layer::DRAWING)
+    std::atomic<std::thread::id> m_drawing_thread{};
+#endif
 
-    void init();
+    job_system *m_jobs = nullptr;
+
+    bool m_threaded_rendering = false;
+    frame_handoff m_handoff;
+    std::array<camera_snapshot, frame_handoff::SLOTS> m_camera_snapshots;
+    std::atomic<float> m_swap_chain_aspect = 1.f;
+
+    lynx::render_stats m_render_stats;
+    kit::scope<render_stats_history> m_stats_history;
+    mutable std::mutex m_stats_mutex;
+
+    void init(const swap_chain::config_info &config);
+    void collect_stats();
+    void dispatch(VkCommandBuffer command_buffer) const;
     void render(VkCommandBuffer command_buffer) const;
+    void use_slots(std::uint32_t record_slot, std::uint32_t render_slot);
+
+    static std::uint64_t pack_extent(std::uint32_t width, std::uint32_t height);
 };
 
 using window2D = window<dimension::two>;
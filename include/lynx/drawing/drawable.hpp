@@ -38,6 +38,13 @@ enum class topology
     TRIANGLE_STRIP = 4
 };
 
+enum class line_join
+{
+    NONE = 0,
+    MITER = 1,
+    ROUND = 2
+};
+
 template <Dimension Dim> class drawable
 {
   public:
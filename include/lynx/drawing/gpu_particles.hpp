@@ -0,0 +1,68 @@
+#pragma once
+
+#include "lynx/drawing/drawable.hpp"
+#include "lynx/drawing/color.hpp"
+#include "lynx/rendering/render_system.hpp"
+#include "lynx/rendering/buffer.hpp"
+#include "kit/utility/transform.hpp"
+#include "lynx/internal/dimension.hpp"
+#include "lynx/internal/context.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_INTRINSICS
+#include <glm/glm.hpp>
+#include <span>
+#include <atomic>
+
+namespace lynx
+{
+// A particle set whose state lives entirely in a gpu storage buffer. The cpu only uploads the initial state; after that,
+// particles are integrated by a compute shader (gravity, damping and lifetime) and rendered from the same buffer
+template <Dimension Dim> class gpu_particles : public drawable<Dim>, kit::non_copyable
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+    using transform_t = typename Dim::transform_t;
+    using context_t = context<Dim>;
+
+    gpu_particles(std::size_t capacity);
+    gpu_particles(std::span<const gpu_particle> particles);
+
+    void draw(window_t &win) const override;
+
+    void reset(std::span<const gpu_particle> particles);
+    void step(float dt);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+    const vec_t &gravity() const;
+    void gravity(const vec_t &gravity);
+
+    float damping() const;
+    void damping(float damping);
+
+    bool round() const;
+    void round(bool round);
+
+    static gpu_particle particle(const vec_t &position, const vec_t &velocity, float lifetime, float size = 1.f,
+                                 const lynx::color &color = lynx::color::white);
+
+    transform_t transform{};
+
+  private:
+    kit::ref<buffer> m_particles;
+    std::size_t m_size = 0;
+    // Shared with the particle render system, which consumes it when the integration is recorded
+    kit::ref<std::atomic<float>> m_pending_dt = kit::make_ref<std::atomic<float>>(0.f);
+
+    vec_t m_gravity{0.f};
+    float m_damping = 0.f;
+    bool m_round = true;
+};
+
+using gpu_particles2D = gpu_particles<dimension::two>;
+using gpu_particles3D = gpu_particles<dimension::three>;
+} // namespace lynx
@@ -115,4 +115,138 @@ template <Dimension Dim> class line_strip : public drawable<Dim>, public modelab
 using line_strip2D = line_strip<dimension::two>;
 using line_strip3D = line_strip<dimension::three>;
 
+template <Dimension Dim> class thick_line : public line<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+
+    thick_line(const vec_t &p1 = vec_t(-1.f), const vec_t &p2 = vec_t(1.f), float width = 2.f,
+               const lynx::color &color = lynx::color::white);
+    thick_line(float width, const lynx::color &color = lynx::color::white);
+
+    void draw(window_t &win) const override final;
+
+    const vec_t &p1() const override final;
+    const vec_t &p2() const override final;
+
+    void p1(const vec_t &p1) override final;
+    void p2(const vec_t &p2) override final;
+
+    const lynx::color &color() const override final;
+    void color(const lynx::color &color) override final;
+
+    float width() const;
+    void width(float width);
+
+    bool rounded_caps() const;
+    void rounded_caps(bool rounded);
+
+  private:
+    vec_t m_p1;
+    vec_t m_p2;
+    float m_width;
+    lynx::color m_color;
+    bool m_rounded_caps = false;
+};
+
+using thick_line2D = thick_line<dimension::two>;
+using thick_line3D = thick_line<dimension::three>;
+
+template <Dimension Dim> class thick_line_strip : public drawable<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+    using transform_t = typename Dim::transform_t;
+
+    thick_line_strip(const std::vector<vec_t> &points = {vec_t(-1.f), vec_t(1.f)}, float width = 2.f,
+                     const lynx::color &color = lynx::color::white, line_join join = line_join::MITER);
+    thick_line_strip(float width, const lynx::color &color = lynx::color::white, line_join join = line_join::MITER);
+
+    void draw(window_t &win) const override;
+
+    const vec_t &operator[](std::size_t index) const;
+    vec_t &operator[](std::size_t index);
+
+    const std::vector<vec_t> &points() const;
+    std::vector<vec_t> &points();
+    std::size_t size() const;
+
+    const color &color() const;
+    void color(const lynx::color &color);
+
+    float width() const;
+    void width(float width);
+
+    line_join join() const;
+    void join(line_join join);
+
+    transform_t transform{};
+
+  private:
+    std::vector<vec_t> m_points;
+    float m_width;
+    lynx::color m_color;
+    line_join m_join;
+
+    mutable std::vector<vec_t> m_transformed_points;
+};
+
+using thick_line_strip2D = thick_line_strip<dimension::two>;
+using thick_line_strip3D = thick_line_strip<dimension::three>;
+
+// A fixed capacity line strip backed by a circular vertex buffer. Appending a point is O(1) and only writes a single
+// vertex (two when wrapping around index 0, which is mirrored at the end of the buffer). Once full, the oldest point
+// is overwritten
+template <Dimension Dim> class trail : public drawable<Dim>, public modelable<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+    using model_t = typename Dim::model_t;
+    using transform_t = typename Dim::transform_t;
+    using vertex_t = vertex<Dim>;
+    using context_t = context<Dim>;
+
+    trail(std::size_t capacity, const lynx::color &color = lynx::color::white, bool fade = false);
+
+    void draw(window_t &win) const override;
+
+    void append(const vec_t &point);
+    void append(const vec_t &point, const lynx::color &color);
+    void clear();
+
+    const vertex_t &operator[](std::size_t index) const;
+    const vertex_t &front() const;
+    const vertex_t &back() const;
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    bool empty() const;
+    bool full() const;
+
+    const color &color() const;
+    void color(const lynx::color &color);
+
+    bool fade() const;
+    void fade(bool fade);
+
+    const transform_t *parent() const;
+    void parent(const transform_t *parent);
+
+  private:
+    transform_t m_transform;
+    lynx::color m_color;
+    std::size_t m_capacity;
+    std::size_t m_start = 0;
+    std::size_t m_count = 0;
+    bool m_fade;
+
+    void write(std::size_t index, const vertex_t &vtx);
+};
+
+using trail2D = trail<dimension::two>;
+using trail3D = trail<dimension::three>;
+
 } // namespace lynx
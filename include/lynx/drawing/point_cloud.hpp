@@ -0,0 +1,82 @@
+#pragma once
+
+#include "lynx/drawing/drawable.hpp"
+#include "lynx/drawing/color.hpp"
+#include "lynx/geometry/vertex.hpp"
+#include "lynx/buffer/tight_buffer.hpp"
+#include "kit/utility/transform.hpp"
+#include "lynx/internal/dimension.hpp"
+#include "lynx/internal/context.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_INTRINSICS
+#include <glm/glm.hpp>
+#include <span>
+
+namespace lynx
+{
+// A large set of points stored in a single persistently mapped buffer and rendered with one draw call. Points can be
+// updated in bulk (a plain memcpy when the layout matches) or written directly through data(). Sizes are in pixels
+template <Dimension Dim> class point_cloud : public drawable<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+    using transform_t = typename Dim::transform_t;
+    using point_t = point_vertex<Dim>;
+    using point_buffer_t = tight_buffer<point_t>;
+    using context_t = context<Dim>;
+
+    point_cloud(std::size_t capacity = 1024, float size = 1.f, const lynx::color &color = lynx::color::white);
+
+    point_cloud(const point_cloud &other);
+    point_cloud &operator=(const point_cloud &other);
+
+    point_cloud(point_cloud &&other) = default;
+    point_cloud &operator=(point_cloud &&other) = default;
+
+    void draw(window_t &win) const override;
+
+    void update(std::span<const point_t> points, std::size_t offset = 0);
+    void update(std::span<const vec_t> positions, std::size_t offset = 0);
+    void update_sizes(std::span<const float> sizes, std::size_t offset = 0);
+    void update_colors(std::span<const lynx::color> colors, std::size_t offset = 0);
+
+    void resize(std::size_t size);
+    void reserve(std::size_t capacity);
+
+    const point_t *data() const;
+    point_t *data();
+
+    const point_t &operator[](std::size_t index) const;
+    point_t &operator[](std::size_t index);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    bool empty() const;
+
+    float point_size() const;
+    void point_size(float size);
+
+    const lynx::color &color() const;
+    void color(const lynx::color &color);
+
+    bool round() const;
+    void round(bool round);
+
+    transform_t transform{};
+
+  private:
+    kit::ref<point_buffer_t> m_points;
+    std::size_t m_size = 0;
+    float m_point_size;
+    lynx::color m_color;
+    bool m_round = false;
+
+    void fill_defaults(std::size_t from, std::size_t to);
+};
+
+using point_cloud2D = point_cloud<dimension::two>;
+using point_cloud3D = point_cloud<dimension::three>;
+} // namespace lynx
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "lynx/drawing/drawable.hpp"
+#include "lynx/drawing/model.hpp"
+#include "lynx/drawing/color.hpp"
+#include "lynx/geometry/vertex.hpp"
+#include "kit/utility/transform.hpp"
+#include "lynx/internal/dimension.hpp"
+#include "lynx/internal/context.hpp"
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define GLM_FORCE_INTRINSICS
+#include <glm/glm.hpp>
+
+namespace lynx
+{
+// Many line or triangle strips packed into a single indexed model and separated by the primitive restart index, so
+// that the whole batch is rendered with one draw call. Buffers grow geometrically, and the unused index tail is filled
+// with restart indices so it never produces primitives
+template <Dimension Dim> class strip_batch : public drawable<Dim>, public modelable<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using window_t = window<Dim>;
+    using model_t = typename Dim::model_t;
+    using transform_t = typename Dim::transform_t;
+    using vertex_t = vertex<Dim>;
+    using context_t = context<Dim>;
+    using drawable_t = drawable<Dim>;
+
+    static inline constexpr std::uint32_t RESTART_INDEX = 0xFFFFFFFF;
+
+    struct strip
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    strip_batch(topology tplg = topology::LINE_STRIP, std::size_t vertex_capacity = 64);
+
+    void draw(window_t &win) const override;
+
+    std::size_t add_strip(const std::vector<vertex_t> &vertices);
+    std::size_t add_strip(const std::vector<vec_t> &points, const lynx::color &color = lynx::color::white);
+    void clear();
+
+    const vertex_t &vertex(std::size_t strip_index, std::size_t index) const;
+    void vertex(std::size_t strip_index, std::size_t index, const vertex_t &vtx);
+
+    const strip &operator[](std::size_t strip_index) const;
+
+    std::size_t strip_count() const;
+    std::size_t vertex_count() const;
+    std::size_t vertex_capacity() const;
+    bool empty() const;
+
+    void color(const lynx::color &color);
+
+    transform_t transform{};
+
+  private:
+    topology m_topology;
+    std::vector<strip> m_strips;
+    std::size_t m_vertex_count = 0;
+    std::size_t m_index_count = 0;
+
+    void reserve(std::size_t vertex_capacity, std::size_t index_capacity);
+};
+
+using strip_batch2D = strip_batch<dimension::two>;
+using strip_batch3D = strip_batch<dimension::three>;
+} // namespace lynx
@@ -31,4 +31,26 @@ template <Dimension Dim> struct vertex
 
 using vertex2D = vertex<dimension::two>;
 using vertex3D = vertex<dimension::three>;
+
+// Compact vertex used by point clouds. The color is packed as RGBA8 (red in the lowest byte) and unpacked by the vertex
+// input stage
+template <Dimension Dim> struct point_vertex
+{
+    using vec_t = glm::vec<Dim::N, float>;
+    point_vertex() = default;
+    point_vertex(const vec_t &position, float size = 1.f, const color &color = color::white);
+
+    vec_t position;
+    float size = 1.f;
+    std::uint32_t color = 0xFFFFFFFF;
+
+    static std::uint32_t pack(const lynx::color &color);
+
+    static std::vector<VkVertexInputBindingDescription> binding_descriptions(
+        VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX);
+    static std::vector<VkVertexInputAttributeDescription> attribute_descriptions();
+};
+
+using point_vertex2D = point_vertex<dimension::two>;
+using point_vertex3D = point_vertex<dimension::three>;
 } // namespace lynx
@@ -27,6 +27,7 @@
 #include <thread>
 #include "kit/debug/log.hpp"
 #include "kit/profiling/perf.hpp"
+#include "lynx/profiling/trace.hpp"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
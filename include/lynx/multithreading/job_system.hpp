@@ -0,0 +1,126 @@
+#pragma once
+
+#include "lynx/multithreading/scratch_arena.hpp"
+#include "kit/interface/non_copyable.hpp"
+#include "kit/memory/ptr/ref.hpp"
+#include "kit/memory/ptr/scope.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lynx
+{
+// Work stealing thread pool. Each worker owns a deque of jobs: it pushes and pops at the back, so that the most
+// recently spawned (and cache hot) work runs first, while idle workers steal from the front of the others'. Jobs
+// submitted from threads outside the pool go to a shared queue. A job may depend on others, and runs once all of them
+// completed, so jobs and their continuations form task graphs. Threads waiting on a job run other jobs meanwhile
+// instead of blocking, so a job can wait on jobs it spawns. Every job is recorded as a trace scope under its name
+class job_system : kit::non_copyable
+{
+  public:
+    class job : kit::non_copyable
+    {
+      public:
+        job(const char *name, std::function<void()> &&task);
+
+        const char *name() const;
+        bool done() const;
+
+      private:
+        const char *m_name;
+        std::function<void()> m_task;
+        // Starts at one so that the job cannot be scheduled while its dependencies are still being registered
+        std::atomic<std::uint32_t> m_pending{1};
+        std::atomic<bool> m_done{false};
+        std::mutex m_mutex;
+        std::vector<kit::ref<job>> m_continuations;
+
+        friend class job_system;
+    };
+    using handle = kit::ref<job>;
+
+    // Zero workers sizes the pool to the hardware concurrency, minus one for the thread that submits most work
+    job_system(std::uint32_t workers = 0);
+    // Jobs that did not start yet are dropped
+    ~job_system();
+
+    // The name must outlive the trace (a string literal, usually)
+    handle submit(const char *name, std::function<void()> task, const std::vector<handle> &dependencies = {});
+    // Continuation: the job runs after the parent completed
+    handle then(const handle &parent, const char *name, std::function<void()> task);
+
+    void wait(const handle &jb);
+    void wait(const std::vector<handle> &jobs);
+
+    // Calls fn(index) for every index in [begin, end), split in chunks of grain indices (or evenly across the pool if
+    // zero), and returns once all of them are done. The calling thread runs chunks as well
+    template <class F>
+    void parallel_for(const char *name, const std::size_t begin, const std::size_t end, F &&fn, std::size_t grain = 0)
+    {
+        if (begin >= end)
+            return;
+        const std::size_t count = end - begin;
+        if (grain == 0)
+            grain = std::max<std::size_t>(1, count / (4 * ((std::size_t)worker_count() + 1)));
+
+        std::vector<handle> chunks;
+        chunks.reserve((count + grain - 1) / grain);
+        for (std::size_t start = begin; start < end; start += grain)
+        {
+            const std::size_t stop = std::min(start + grain, end);
+            chunks.push_back(submit(name, [&fn, start, stop] {
+                for (std::size_t i = start; i < stop; i++)
+                    fn(i);
+            }));
+        }
+        wait(chunks);
+    }
+
+    std::uint32_t worker_count() const;
+    // Index of the calling worker, or worker_count() if the calling thread is not part of the pool
+    std::uint32_t worker_index() const;
+
+    // Scratch memory of the calling thread, which must be a worker or the thread that created the job system: other
+    // threads have no arena that reset_scratch could reach. It is only valid until reset_scratch, which the app calls
+    // at the start of every frame, so it must not be handed to jobs that outlive the frame
+    scratch_arena &scratch();
+    // Resets the arenas of every worker and of the owning thread, from which it must be called. No job may be running
+    void reset_scratch();
+
+    std::uint64_t executed_jobs() const;
+    std::uint64_t stolen_jobs() const;
+
+  private:
+    struct worker
+    {
+        std::deque<handle> queue;
+        std::mutex mutex;
+        scratch_arena scratch;
+        std::thread thread;
+    };
+
+    std::vector<kit::scope<worker>> m_workers;
+    std::thread::id m_owner = std::this_thread::get_id();
+    scratch_arena m_owner_scratch;
+    std::deque<handle> m_shared_queue;
+    std::mutex m_shared_mutex;
+
+    // Bumped on every schedule, so that idle workers can sleep on it without missing work pushed meanwhile
+    std::atomic<std::uint64_t> m_epoch{0};
+    std::atomic<bool> m_stopping{false};
+
+    std::atomic<std::uint64_t> m_executed_jobs{0};
+    std::atomic<std::uint64_t> m_stolen_jobs{0};
+
+    void worker_loop(std::uint32_t index);
+    void schedule(handle jb);
+    handle find_job(std::uint32_t index);
+    void execute(const handle &jb);
+};
+} // namespace lynx
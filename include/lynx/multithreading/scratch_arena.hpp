@@ -0,0 +1,45 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace lynx
+{
+// Linear allocator for short lived scratch memory. Allocating bumps an offset within the current block, and a block
+// twice as large is chained when it runs out. Nothing is freed individually: reset makes the memory reusable at once,
+// keeping only the largest block so that a steady workload stops allocating after a few frames. Nothing allocated from
+// it is ever destroyed, so it only hands out trivially destructible types
+class scratch_arena : kit::non_copyable
+{
+  public:
+    scratch_arena(std::size_t block_size = 64 * 1024);
+
+    void *allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    template <class T> T *allocate(const std::size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "Scratch memory is never destroyed");
+        return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+
+    std::size_t used() const;
+    std::size_t capacity() const;
+
+  private:
+    struct block
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t size;
+    };
+
+    std::size_t m_block_size;
+    std::vector<block> m_blocks;
+    std::size_t m_offset = 0;
+    std::size_t m_used = 0;
+};
+} // namespace lynx
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+#include "kit/profiling/perf.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define LYNX_TRACE_CONCAT_IMPL(a, b) a##b
+#define LYNX_TRACE_CONCAT(a, b) LYNX_TRACE_CONCAT_IMPL(a, b)
+
+// Feeds both the kit profiler and the lynx timeline. The name must outlive the trace (a string literal, usually)
+#ifdef LYNX_DISABLE_TRACE
+#define LYNX_TRACE_SCOPE(name) KIT_PERF_SCOPE(name)
+#else
+#define LYNX_TRACE_SCOPE(name)                                                                                         \
+    KIT_PERF_SCOPE(name)                                                                                               \
+    const lynx::trace::scope LYNX_TRACE_CONCAT(lynx_trace_scope, __LINE__)(name);
+#endif
+
+namespace lynx
+{
+struct gpu_scope_timing;
+
+// Collects nested cpu scopes from every thread into per thread ring buffers that are written without locking, along
+// with frame markers and gpu scope timings, and dumps them as Chrome trace event JSON (loadable by chrome://tracing or
+// ui.perfetto.dev). While stopped, a scope costs a single relaxed atomic load. Dumping reads other threads' buffers
+// without synchronizing with their writers, so it should be done between frames, when the worker threads are idle
+class trace
+{
+  public:
+    class scope : kit::non_copyable
+    {
+      public:
+        scope(const char *name);
+        ~scope();
+
+      private:
+        const char *m_name;
+        std::uint64_t m_begin;
+    };
+
+    static void start(std::size_t events_per_thread = 1 << 16, std::size_t max_frames = 1024);
+    static void stop();
+    static bool recording();
+    static void clear();
+
+    static void mark_frame();
+    // Gpu scopes have no clock in common with the cpu, so they are placed relative to an anchor (usually the time the
+    // frame was submitted). Offsets within a frame are exact, the anchor is an approximation
+    static void record_gpu(std::uint64_t anchor, const std::vector<gpu_scope_timing> &timings,
+                           float frame_milliseconds);
+
+    // Only the last frames are dumped if last_frames is not zero
+    static void dump(const std::string &path, std::size_t last_frames = 0);
+
+    static std::uint64_t now();
+
+  private:
+    static inline std::atomic<bool> s_recording{false};
+};
+} // namespace lynx
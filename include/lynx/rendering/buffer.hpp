@@ -66,7 +66,5 @@ class buffer : kit::non_copyable
 
     VkBufferUsageFlags m_usage;
     VkMemoryPropertyFlags m_properties;
-
-    VkMappedMemoryRange mapped_memory_range(VkDeviceSize size, VkDeviceSize offset);
 };
 } // namespace lynx
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+#include "lynx/rendering/device.hpp"
+#include "kit/memory/ptr/ref.hpp"
+#include <vector>
+
+namespace lynx
+{
+class buffer;
+
+// A compute pipeline whose only resources are storage buffers (bound to consecutive bindings of set 0) and an optional
+// push constant range. Descriptor sets are allocated from internally managed pools that grow on demand
+class compute_pipeline : kit::non_copyable
+{
+  public:
+    struct config_info
+    {
+        const char *compute_shader_path = nullptr;
+        std::uint32_t storage_buffer_count = 1;
+        std::uint32_t constant_range_size = 0;
+        std::uint32_t sets_per_pool = 16;
+    };
+
+    compute_pipeline(const kit::ref<const device> &dev, const config_info &config);
+    ~compute_pipeline();
+
+    void bind(VkCommandBuffer command_buffer) const;
+    void bind_descriptor_set(VkCommandBuffer command_buffer, VkDescriptorSet set) const;
+    void push_constants(VkCommandBuffer command_buffer, const void *data, std::uint32_t size) const;
+    void dispatch(VkCommandBuffer command_buffer, std::uint32_t group_count_x, std::uint32_t group_count_y = 1,
+                  std::uint32_t group_count_z = 1) const;
+
+    VkDescriptorSet allocate_descriptor_set();
+    void write_descriptor_set(VkDescriptorSet set, const std::vector<const buffer *> &storage_buffers) const;
+
+    VkPipelineLayout pipeline_layout() const;
+
+  private:
+    kit::ref<const device> m_device;
+    config_info m_config;
+
+    VkPipeline m_compute_pipeline;
+    VkPipelineLayout m_pipeline_layout;
+    VkDescriptorSetLayout m_set_layout;
+    VkShaderModule m_comp_shader_module;
+
+    std::vector<VkDescriptorPool> m_pools;
+    std::uint32_t m_sets_in_last_pool = 0;
+
+    void create_set_layout();
+    void create_pipeline_layout();
+    void create_pipeline();
+    void create_pool();
+};
+} // namespace lynx
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <vector>
+#include <unordered_map>
+#include <mutex>
 #include <vulkan/vulkan.hpp>
 #include "kit/interface/non_copyable.hpp"
+#include "lynx/rendering/render_stats.hpp"
 #include <GLFW/glfw3.h>
 
 namespace lynx
@@ -27,7 +31,10 @@ class device : kit::non_copyable
         bool is_complete() const;
     };
 
-    explicit device(GLFWwindow *window);
+    // A null window creates a headless device: no surface is created and the swap chain extension is not required.
+    // The null backend goes further and does not touch Vulkan at all: buffers live in host memory and every command is
+    // dropped, so the cpu side of the library can be measured on machines without a Vulkan driver
+    explicit device(GLFWwindow *window, bool null_backend = false);
     ~device();
 
     VkCommandPool command_pool() const;
@@ -38,6 +45,10 @@ class device : kit::non_copyable
     VkQueue graphics_queue() const;
     VkQueue present_queue() const;
     VkPhysicalDeviceProperties properties() const;
+    VkPhysicalDeviceFeatures features() const;
+    bool headless() const;
+    bool null_backend() const;
+    void wait_idle() const;
 
     swap_chain_support_details swap_chain_support() const;
     std::uint32_t find_memory_type(std::uint32_t type_filter, VkMemoryPropertyFlags properties) const;
@@ -49,6 +60,8 @@ class device : kit::non_copyable
     void create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer,
                        VkDeviceMemory &buffer_memory) const;
 
+    // Single time commands come from their own pool, which is held from begin to end so that uploads may be issued from
+    // any thread without racing the renderer's command buffers
     VkCommandBuffer begin_single_time_commands() const;
     void end_single_time_commands(VkCommandBuffer command_buffer) const;
     void copy_buffer(VkBuffer dst_buffer, VkBuffer src_buffer, VkDeviceSize size) const;
@@ -56,24 +69,112 @@ class device : kit::non_copyable
     void copy_buffer_to_image(VkBuffer buffer, VkImage image, std::uint32_t width, std::uint32_t height,
                               std::uint32_t layer_count) const;
 
+    // LAZILY_ALLOCATED is treated as a preference and dropped when no memory type for the image supports it
     void create_image_with_info(const VkImageCreateInfo &image_info, VkMemoryPropertyFlags properties, VkImage &image,
                                 VkDeviceMemory &image_memory) const;
+    void free_memory(VkDeviceMemory memory) const;
+    void destroy_buffer(VkBuffer buffer, VkDeviceMemory buffer_memory) const;
+
+    void *map_memory(VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags) const;
+    void unmap_memory(VkDeviceMemory memory) const;
+    void flush_memory(VkDeviceMemory memory, VkDeviceSize size, VkDeviceSize offset) const;
+    void invalidate_memory(VkDeviceMemory memory, VkDeviceSize size, VkDeviceSize offset) const;
+
+    // Objects the null backend creates have no state, so they all share one placeholder per type. It is never null, so
+    // that it passes the same checks real handles do
+    template <typename Handle> static Handle null_handle()
+    {
+        static char placeholder;
+        return (Handle)(std::uintptr_t)&placeholder;
+    }
+
+    // Object creation and destruction. The null backend hands out null_handle placeholders and loads no shader code
+    VkShaderModule create_shader_module(const char *path) const;
+    VkPipelineLayout create_pipeline_layout(const VkPipelineLayoutCreateInfo &layout_info) const;
+    VkPipeline create_graphics_pipeline(const VkGraphicsPipelineCreateInfo &pipeline_info) const;
+    VkPipeline create_compute_pipeline(const VkComputePipelineCreateInfo &pipeline_info) const;
+    VkDescriptorSetLayout create_descriptor_set_layout(const VkDescriptorSetLayoutCreateInfo &layout_info) const;
+    VkDescriptorPool create_descriptor_pool(const VkDescriptorPoolCreateInfo &pool_info) const;
+    VkDescriptorSet allocate_descriptor_set(const VkDescriptorSetAllocateInfo &alloc_info) const;
+    void update_descriptor_sets(const std::vector<VkWriteDescriptorSet> &writes) const;
+
+    void destroy_shader_module(VkShaderModule shader_module) const;
+    void destroy_pipeline_layout(VkPipelineLayout pipeline_layout) const;
+    void destroy_pipeline(VkPipeline pipeline) const;
+    void destroy_descriptor_set_layout(VkDescriptorSetLayout set_layout) const;
+    void destroy_descriptor_pool(VkDescriptorPool pool) const;
+
+    // Command buffers come from the main command pool. The null backend hands out distinct placeholders
+    void allocate_command_buffers(VkCommandBuffer *command_buffers, std::uint32_t count) const;
+    void free_command_buffers(const VkCommandBuffer *command_buffers, std::uint32_t count) const;
+    void begin_command_buffer(VkCommandBuffer command_buffer) const;
+    void end_command_buffer(VkCommandBuffer command_buffer) const;
+
+    // Command recording. Every command is counted in the stats, and the null backend drops it afterwards
+    void begin_render_pass(VkCommandBuffer command_buffer, const VkRenderPassBeginInfo &pass_info) const;
+    void end_render_pass(VkCommandBuffer command_buffer) const;
+    void set_viewport(VkCommandBuffer command_buffer, const VkViewport &viewport) const;
+    void set_scissor(VkCommandBuffer command_buffer, const VkRect2D &scissor) const;
+    void bind_pipeline(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipeline pipeline) const;
+    void bind_descriptor_set(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout,
+                             VkDescriptorSet set) const;
+    void push_constants(VkCommandBuffer command_buffer, VkPipelineLayout layout, VkShaderStageFlags stages,
+                        std::uint32_t size, const void *data) const;
+    void bind_vertex_buffer(VkCommandBuffer command_buffer, VkBuffer buffer) const;
+    void bind_index_buffer(VkCommandBuffer command_buffer, VkBuffer buffer) const;
+    void draw(VkCommandBuffer command_buffer, std::uint32_t vertex_count, std::uint32_t instance_count = 1,
+              std::uint32_t first_vertex = 0) const;
+    void draw_indexed(VkCommandBuffer command_buffer, std::uint32_t index_count,
+                      std::uint32_t instance_count = 1) const;
+    void dispatch(VkCommandBuffer command_buffer, std::uint32_t group_count_x, std::uint32_t group_count_y,
+                  std::uint32_t group_count_z) const;
+    // Execution dependency between the two stages, with an optional global memory barrier
+    void pipeline_barrier(VkCommandBuffer command_buffer, VkPipelineStageFlags src_stages,
+                          VkPipelineStageFlags dst_stages, const VkMemoryBarrier *barrier = nullptr) const;
+
+    // Queues are externally synchronized. Every submission, presentation or device wait must hold this lock, as they
+    // may come from both the update and the render thread when rendering runs on its own thread
+    std::unique_lock<std::mutex> lock_queues() const;
+
+    // Counters are mutable so that every holder of the device can record into them while rendering. Only the thread
+    // recording commands may touch them. Allocations can happen on any thread, so they are counted apart
+    render_stats &stats() const;
+    // Adds the allocations and frees made since the last call to the given stats
+    void collect_allocation_stats(render_stats &stats) const;
+
+    // Memory currently allocated through the device (buffers and images)
+    VkDeviceSize allocated_memory() const;
+    std::size_t allocation_count() const;
 
   private:
+    bool m_headless;
+    bool m_null_backend;
     VkInstance m_instance;
 #ifdef DEBUG
     VkDebugUtilsMessengerEXT m_debug_messenger;
 #endif
     VkPhysicalDevice m_physical_device = VK_NULL_HANDLE;
     VkCommandPool m_command_pool;
+    VkCommandPool m_transfer_command_pool;
 
     VkPhysicalDeviceProperties m_properties;
+    VkPhysicalDeviceFeatures m_features;
+    mutable render_stats m_stats;
+    mutable render_stats m_allocation_stats;
+    mutable std::unordered_map<VkDeviceMemory, VkDeviceSize> m_allocations;
+    mutable VkDeviceSize m_allocated_memory = 0;
+
+    mutable std::mutex m_queue_mutex;
+    mutable std::mutex m_transfer_mutex;
+    mutable std::mutex m_allocation_mutex;
 
     VkDevice m_device;
-    VkSurfaceKHR m_surface;
+    VkSurfaceKHR m_surface = VK_NULL_HANDLE;
     VkQueue m_graphics_queue;
     VkQueue m_present_queue;
 
+    void create_null_backend();
+    void track_allocation(VkDeviceMemory memory, VkDeviceSize size) const;
     void create_instance();
 #ifdef DEBUG
     void setup_debug_messenger();
@@ -83,7 +184,9 @@ class device : kit::non_copyable
     void create_command_pool();
 
     bool is_device_suitable(VkPhysicalDevice device) const;
+    bool has_memory_type(std::uint32_t type_filter, VkMemoryPropertyFlags properties) const;
     std::vector<const char *> required_extensions() const;
+    std::vector<const char *> device_extensions() const;
 #ifdef DEBUG
     bool check_validation_layer_support() const;
     void populate_debug_messenger_create_info(VkDebugUtilsMessengerCreateInfoEXT &createInfo) const;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+#include "kit/memory/ptr/ref.hpp"
+#include "lynx/rendering/device.hpp"
+#include "lynx/rendering/swap_chain.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <vector>
+
+namespace lynx
+{
+// Offscreen target the scene is rendered into at a fraction of the swap chain resolution, and then upscaled into the
+// swap chain image with a blit. A composite pass, compatible with the swap chain's, keeps the upscaled image and lets
+// overlays such as ImGui draw on top at native resolution. The target is allocated at full resolution and rendered
+// into a scaled sub rectangle, so changing the scale never reallocates. The scale is driven by a controller that
+// compares the measured gpu frame time against a budget: the cost of a frame is roughly proportional to its pixel
+// count, so the ideal scale is the current one times the square root of the budget over the frame time. The scale
+// moves towards it a fraction at a time and only while the frame time is outside a tolerance band, to avoid visibly
+// oscillating between resolutions
+class dynamic_resolution : kit::non_copyable
+{
+  public:
+    struct specs
+    {
+        float target_milliseconds = 16.f;
+        float min_scale = 0.5f;
+        float max_scale = 1.f;
+        float gain = 0.2f;
+        float tolerance = 0.05f;
+    };
+
+    dynamic_resolution(const kit::ref<const device> &dev, const swap_chain &swpc, const specs &spc);
+    ~dynamic_resolution();
+
+    // Rebuilds the target for a new swap chain. Nothing rendered with the previous one may still be in flight
+    void resize(const swap_chain &swpc);
+
+    // Feeds the gpu time of a frame recorded at the given generation. Frames recorded before the last scale or extent
+    // change are ignored, as they no longer say anything about the cost of the current resolution
+    void update(float gpu_milliseconds, std::uint32_t generation);
+    void upscale(VkCommandBuffer command_buffer, VkImage swap_chain_image) const;
+
+    float scale() const;
+    // Forces a scale (clamped to the specs' range). The controller keeps adjusting it from there
+    void scale(float scale);
+
+    float target_milliseconds() const;
+    void target_milliseconds(float target);
+
+    VkExtent2D scaled_extent() const;
+    // Increases every time the scale or the extent changes. Starts at 1, so 0 may tag frames rendered without it
+    std::uint32_t generation() const;
+
+    VkRenderPass render_pass() const;
+    VkFramebuffer frame_buffer() const;
+    VkRenderPass composite_render_pass() const;
+    VkFramebuffer composite_frame_buffer(std::size_t image_index) const;
+
+  private:
+    kit::ref<const device> m_device;
+    specs m_specs;
+    float m_scale;
+    std::uint32_t m_generation = 1;
+
+    VkExtent2D m_extent;
+    VkFormat m_color_format;
+    VkFormat m_depth_format;
+    VkFilter m_filter;
+    bool m_headless;
+
+    VkImage m_color_image = VK_NULL_HANDLE;
+    VkDeviceMemory m_color_memory = VK_NULL_HANDLE;
+    VkImageView m_color_view = VK_NULL_HANDLE;
+    VkImage m_depth_image = VK_NULL_HANDLE;
+    VkDeviceMemory m_depth_memory = VK_NULL_HANDLE;
+    VkImageView m_depth_view = VK_NULL_HANDLE;
+
+    VkRenderPass m_render_pass = VK_NULL_HANDLE;
+    VkRenderPass m_composite_render_pass = VK_NULL_HANDLE;
+    VkFramebuffer m_frame_buffer = VK_NULL_HANDLE;
+    std::vector<VkFramebuffer> m_composite_frame_buffers;
+
+    void create(const swap_chain &swpc);
+    void destroy();
+
+    void create_images();
+    void create_render_passes();
+    void create_frame_buffers(const swap_chain &swpc);
+    VkImageView create_view(VkImage image, VkFormat format, VkImageAspectFlags aspect) const;
+};
+} // namespace lynx
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+#include "kit/memory/ptr/ref.hpp"
+#include "kit/memory/ptr/scope.hpp"
+#include "lynx/rendering/device.hpp"
+#include "lynx/rendering/buffer.hpp"
+#include "lynx/rendering/swap_chain.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+#include <array>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <fstream>
+
+namespace lynx
+{
+struct captured_frame
+{
+    std::uint64_t index;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::vector<std::uint8_t> pixels; // Tightly packed RGBA8, top row first
+};
+
+// Copies every rendered frame into a per frame in flight staging buffer at the end of the command buffer, and reads it
+// back once the frame's fence has signaled (which the renderer already waits on before reusing the frame), so capturing
+// never stalls the frame loop. Frames are handed to a background thread that either calls a user callback or encodes
+// them to disk. If the writer falls MAX_PENDING_FRAMES behind, new frames are dropped and counted instead of queued
+class frame_capture : kit::non_copyable
+{
+  public:
+    static inline constexpr std::size_t MAX_PENDING_FRAMES = 8;
+
+    enum class format
+    {
+        PNG_SEQUENCE, // One uncompressed png per frame, named <path><index>.png
+        RAW_RGBA,     // All frames appended to a single file as raw RGBA8
+        Y4M           // YUV 4:2:0 stream readable by ffmpeg and most video tools
+    };
+
+    struct specs
+    {
+        format fmt = format::PNG_SEQUENCE;
+        std::string path = "frame_";
+        std::uint32_t framerate = 60;
+    };
+
+    using callback = std::function<void(const captured_frame &)>;
+
+    frame_capture(const kit::ref<const device> &dev, const specs &spc);
+    frame_capture(const kit::ref<const device> &dev, callback on_frame);
+    ~frame_capture();
+
+    void record(VkCommandBuffer command_buffer, VkImage image, VkFormat image_format, VkExtent2D extent,
+                VkImageLayout image_layout, std::uint32_t frame_index);
+    void read(std::uint32_t frame_index);
+    void read_all();
+
+    std::uint64_t captured_frames() const;
+    std::size_t pending_frames() const;
+    std::uint64_t dropped_frames() const;
+
+  private:
+    struct slot
+    {
+        kit::scope<buffer> staging;
+        VkExtent2D extent{0, 0};
+        VkFormat image_format = VK_FORMAT_UNDEFINED;
+        std::uint64_t index = 0;
+        bool pending = false;
+    };
+
+    kit::ref<const device> m_device;
+    specs m_specs;
+    callback m_on_frame;
+
+    std::array<slot, swap_chain::MAX_FRAMES_IN_FLIGHT> m_slots;
+    std::uint64_t m_frame_count = 0;
+
+    std::thread m_writer;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<captured_frame> m_queue;
+    std::uint64_t m_dropped_frames = 0;
+    bool m_stop = false;
+
+    std::ofstream m_stream;
+    VkExtent2D m_stream_extent{0, 0};
+
+    void start_writer();
+    void writer_loop();
+    void write(const captured_frame &frame);
+};
+} // namespace lynx
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "kit/interface/non_copyable.hpp"
+#include "kit/memory/ptr/ref.hpp"
+#include "lynx/rendering/device.hpp"
+#include "lynx/rendering/swap_chain.hpp"
+
+#include <vulkan/vulkan.hpp>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace lynx
+{
+struct gpu_scope_timing
+{
+    std::string name;
+    std::uint32_t depth;
+    float milliseconds;
+    float offset_milliseconds; // From the start of the frame
+    std::uint64_t vertex_invocations;   // Only filled when pipeline statistics are enabled
+    std::uint64_t fragment_invocations; // Only filled when pipeline statistics are enabled
+};
+
+// Writes timestamps (and optionally pipeline statistics) around named scopes of a frame's command buffer. Each frame in
+// flight owns its query pools, which are read back without waiting once the frame's fence has signaled, so results
+// always lag one frame in flight behind. Scopes may nest, but pipeline statistics are only gathered for scopes that do
+// not overlap with another statistics scope, as Vulkan forbids nesting queries of the same type
+class gpu_profiler : kit::non_copyable
+{
+  public:
+    static inline constexpr std::uint32_t MAX_SCOPES = 128;
+
+    gpu_profiler(const kit::ref<const device> &dev, bool pipeline_statistics = false);
+    ~gpu_profiler();
+
+    // Returns whether new results were read back from the last frame recorded with this index
+    bool begin_frame(VkCommandBuffer command_buffer, std::uint32_t frame_index);
+    void end_frame(VkCommandBuffer command_buffer);
+
+    void begin_scope(VkCommandBuffer command_buffer, const char *name);
+    void end_scope(VkCommandBuffer command_buffer);
+
+    const std::vector<gpu_scope_timing> &timings() const;
+    float frame_milliseconds() const;
+    bool pipeline_statistics() const;
+
+  private:
+    struct scope_record
+    {
+        std::string name;
+        std::uint32_t depth;
+        std::uint32_t timestamp_query;
+        std::uint32_t statistics_query;
+    };
+
+    struct frame_queries
+    {
+        VkQueryPool timestamps = VK_NULL_HANDLE;
+        VkQueryPool statistics = VK_NULL_HANDLE;
+        std::vector<scope_record> scopes;
+        std::uint32_t statistics_count = 0;
+        bool recorded = false;
+    };
+
+    kit::ref<const device> m_device;
+    bool m_pipeline_statistics;
+    float m_timestamp_period;
+
+    std::array<frame_queries, swap_chain::MAX_FRAMES_IN_FLIGHT> m_frames;
+    std::uint32_t m_frame_index = 0;
+    std::vector<std::uint32_t> m_open_scopes;
+    bool m_statistics_active = false;
+
+    std::vector<gpu_scope_timing> m_timings;
+    float m_frame_milliseconds = 0.f;
+
+    bool read_back(frame_queries &frame);
+};
+} // namespace lynx
@@ -51,6 +51,5 @@ class pipeline : kit::non_copyable
     VkShaderModule m_frag_shader_module;
 
     void init(const config_info &config);
-    void create_shader_module(const std::vector<char> &code, VkShaderModule *shader_module) const;
 };
 } // namespace lynx
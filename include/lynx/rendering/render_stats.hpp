@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+
+namespace lynx
+{
+// Counters gathered between two consecutive displays of a window. Allocations include those made outside of the frame's
+// command recording (for instance, models created during an update)
+struct render_stats
+{
+    struct system_entry
+    {
+        const char *name;
+        std::size_t render_data;
+    };
+
+    std::uint64_t frame = 0;
+
+    std::uint32_t draw_calls = 0;
+    std::uint64_t instances = 0;
+    std::uint64_t vertices = 0;
+    std::uint64_t indices = 0;
+    std::uint32_t dispatches = 0;
+
+    std::uint32_t pipeline_binds = 0;
+    std::uint32_t vertex_buffer_binds = 0;
+    std::uint32_t index_buffer_binds = 0;
+    std::uint64_t push_constant_bytes = 0;
+
+    std::uint32_t allocations = 0;
+    std::uint32_t frees = 0;
+    std::uint64_t allocated_bytes = 0;
+
+    // Gpu time of the last frame whose timestamps were read back, or 0 without gpu profiling
+    float gpu_milliseconds = 0.f;
+
+    std::vector<system_entry> render_systems;
+
+    void draw(std::uint32_t vertex_count, std::uint32_t instance_count = 1);
+    void draw_indexed(std::uint32_t index_count, std::uint32_t instance_count = 1);
+    void dispatch();
+    void bind_pipeline();
+    void bind_vertex_buffers(std::uint32_t count = 1);
+    void bind_index_buffer();
+    void push_constants(std::uint32_t size);
+    void allocate(VkDeviceSize size);
+    void free();
+
+    void reset();
+};
+
+// Keeps the stats of the last frames so that they can be dumped to disk when a scene turns slow
+class render_stats_history
+{
+  public:
+    render_stats_history(std::size_t capacity);
+
+    void push(const render_stats &stats);
+    void clear();
+
+    void dump_csv(const std::string &path) const;
+    void dump_json(const std::string &path) const;
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    const render_stats &operator[](std::size_t index) const;
+
+    auto begin() const
+    {
+        return m_frames.begin();
+    }
+    auto end() const
+    {
+        return m_frames.end();
+    }
+
+  private:
+    std::size_t m_capacity;
+    std::deque<render_stats> m_frames;
+};
+} // namespace lynx
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "lynx/rendering/pipeline.hpp"
+#include "lynx/rendering/compute_pipeline.hpp"
+#include "lynx/rendering/buffer.hpp"
+#include "lynx/rendering/swap_chain.hpp"
 #include "lynx/drawing/model.hpp"
+#include "lynx/buffer/tight_buffer.hpp"
 #include "lynx/internal/dimension.hpp"
 #include "lynx/drawing/drawable.hpp"
+#include "lynx/app/frame_handoff.hpp"
 #include "kit/utility/transform.hpp"
 #include <vulkan/vulkan.hpp>
 #include <utility>
+#include <atomic>
 
 namespace lynx
 {
@@ -35,12 +41,20 @@ template <Dimension Dim> class render_system
 
     virtual ~render_system();
 
-    void init(const kit::ref<const device> &dev, VkRenderPass render_pass);
-    void render(VkCommandBuffer command_buffer, const camera_t &cam) const;
+    virtual void init(const kit::ref<const device> &dev, VkRenderPass render_pass);
+
+    // Called every frame before the swap chain render pass begins. Compute work must be recorded here
+    virtual void dispatch(VkCommandBuffer command_buffer, std::uint32_t frame_index) const;
+    virtual void render(VkCommandBuffer command_buffer, const camera_t &cam, VkExtent2D extent) const;
 
     render_data create_render_data(const kit::ref<const model_t> &mdl, glm::mat4 &transform) const;
     void push_render_data(const render_data &rdata);
-    void clear_render_data();
+    // Clears the record slot
+    virtual void clear_render_data();
+
+    // Used to label the system in gpu profiling results
+    virtual const char *name() const;
+    virtual std::size_t render_data_count() const;
 
     void draw(const std::vector<vertex_t> &vertices, const transform_t &transform = {});
     void draw(const std::vector<vertex_t> &vertices, const std::vector<std::uint32_t> &indices,
@@ -49,16 +63,23 @@ template <Dimension Dim> class render_system
 
   protected:
     kit::ref<const device> m_device;
+    kit::scope<pipeline> m_pipeline;
+    VkPipelineLayout m_pipeline_layout;
 
     void create_pipeline_layout(const pipeline::config_info &config);
     void create_pipeline(VkRenderPass render_pass, pipeline::config_info &config);
 
     virtual void pipeline_config(pipeline::config_info &config) const;
 
+    static float next_z_offset2D();
+
+    // Render data is pushed into the record slot and rendered from the render slot (see frame_handoff), which are the
+    // same one unless rendering runs on its own thread. Each system keeps one set of render data per slot
+    std::uint32_t m_record_slot = 0;
+    std::uint32_t m_render_slot = 0;
+
   private:
-    kit::scope<pipeline> m_pipeline;
-    VkPipelineLayout m_pipeline_layout;
-    std::vector<render_data> m_render_data;
+    std::array<std::vector<render_data>, frame_handoff::SLOTS> m_render_data;
 
     static inline std::uint32_t s_z_offset_counter2D = 0;
     template <Dimension T> friend class window;
@@ -69,26 +90,94 @@ using render_system3D = render_system<dimension::three>;
 
 template <Dimension Dim> class point_render_system final : public render_system<Dim>
 {
+  public:
+    const char *name() const override;
+
+  private:
     void pipeline_config(pipeline::config_info &config) const override;
 };
 
 template <Dimension Dim> class line_render_system final : public render_system<Dim>
 {
+  public:
+    const char *name() const override;
+
+  private:
     void pipeline_config(pipeline::config_info &config) const override;
 };
 
 template <Dimension Dim> class line_strip_render_system final : public render_system<Dim>
 {
+  public:
+    const char *name() const override;
+
+  private:
     void pipeline_config(pipeline::config_info &config) const override;
 };
 
 template <Dimension Dim> class triangle_render_system final : public render_system<Dim>
 {
+  public:
+    const char *name() const override;
+
+  private:
     void pipeline_config(pipeline::config_info &config) const override;
 };
 
 template <Dimension Dim> class triangle_strip_render_system final : public render_system<Dim>
 {
+  public:
+    const char *name() const override;
+
+  private:
+    void pipeline_config(pipeline::config_info &config) const override;
+};
+
+struct thick_segment
+{
+    glm::vec3 p0;
+    glm::vec3 p1;
+    glm::vec3 p2;
+    glm::vec3 p3;
+    float width;
+    color color;
+    std::uint32_t join;
+
+    static std::vector<VkVertexInputBindingDescription> binding_descriptions();
+    static std::vector<VkVertexInputAttributeDescription> attribute_descriptions();
+};
+
+struct thick_line_push_constant_data
+{
+    glm::mat4 projection{1.f};
+    glm::vec2 viewport{1.f};
+};
+
+// Segments are expanded into screen space quads by the vertex shader. p0 and p3 are the neighbouring points used to
+// compute miter joins (they must equal p1 and p2 respectively if there is no neighbour). All segments pushed during a
+// frame are rendered with a single instanced draw call
+template <Dimension Dim> class thick_line_render_system final : public render_system<Dim>
+{
+  public:
+    using vec_t = glm::vec<Dim::N, float>;
+    using camera_t = typename Dim::camera_t;
+
+    void render(VkCommandBuffer command_buffer, const camera_t &cam, VkExtent2D extent) const override;
+    void clear_render_data() override;
+
+    void push_segment(const vec_t &p0, const vec_t &p1, const vec_t &p2, const vec_t &p3, float width,
+                      const color &color, line_join join);
+    void push_segment(const vec_t &p1, const vec_t &p2, float width, const color &color, line_join join);
+    void push_strip(const vec_t *points, std::size_t count, float width, const color &color, line_join join);
+
+    const char *name() const override;
+    std::size_t render_data_count() const override;
+
+  private:
+    std::array<std::vector<thick_segment>, frame_handoff::SLOTS> m_segments;
+    mutable std::array<kit::scope<buffer>, swap_chain::MAX_FRAMES_IN_FLIGHT> m_instance_buffers;
+    mutable std::size_t m_buffer_index = 0;
+
     void pipeline_config(pipeline::config_info &config) const override;
 };
 
@@ -106,4 +195,159 @@ using triangle_render_system3D = triangle_render_system<dimension::three>;
 
 using triangle_strip_render_system2D = triangle_strip_render_system<dimension::two>;
 using triangle_strip_render_system3D = triangle_strip_render_system<dimension::three>;
+
+struct trail_push_constant_data
+{
+    glm::mat4 transform{1.f};
+    std::uint32_t start = 0;
+    std::uint32_t count = 0;
+    std::uint32_t capacity = 0;
+    std::uint32_t fade = 0;
+};
+
+// Renders circular vertex buffers as line strips. The model must hold capacity + 1 vertices, the last one mirroring the
+// first so that a wrapped trail can be drawn with at most two draw calls without breaking the strip
+template <Dimension Dim> class trail_render_system final : public render_system<Dim>
+{
+  public:
+    using model_t = typename Dim::model_t;
+    using camera_t = typename Dim::camera_t;
+
+    struct trail_data
+    {
+        kit::ref<const model_t> mdl;
+        glm::mat4 mdl_transform;
+        std::uint32_t start;
+        std::uint32_t count;
+        bool fade;
+    };
+
+    void render(VkCommandBuffer command_buffer, const camera_t &cam, VkExtent2D extent) const override;
+    void clear_render_data() override;
+
+    void push_trail_data(const kit::ref<const model_t> &mdl, glm::mat4 transform, std::uint32_t start,
+                         std::uint32_t count, bool fade);
+
+    const char *name() const override;
+    std::size_t render_data_count() const override;
+
+  private:
+    std::array<std::vector<trail_data>, frame_handoff::SLOTS> m_trail_data;
+
+    void pipeline_config(pipeline::config_info &config) const override;
+};
+
+struct point_cloud_push_constant_data
+{
+    glm::mat4 transform{1.f};
+    glm::vec2 viewport{1.f};
+    std::uint32_t sprites = 0;
+    std::uint32_t round = 0;
+};
+
+// Renders whole point buffers with a single draw each. Point sizes are given in pixels. If the device cannot rasterize
+// large points, each point is instead expanded into a screen space quad by an instanced draw
+template <Dimension Dim> class point_cloud_render_system final : public render_system<Dim>
+{
+  public:
+    using point_t = point_vertex<Dim>;
+    using point_buffer_t = tight_buffer<point_t>;
+    using camera_t = typename Dim::camera_t;
+
+    struct cloud_data
+    {
+        kit::ref<const point_buffer_t> points;
+        glm::mat4 mdl_transform;
+        std::uint32_t count;
+        bool round;
+    };
+
+    static inline constexpr float MIN_POINT_SIZE_RANGE = 64.f;
+
+    void render(VkCommandBuffer command_buffer, const camera_t &cam, VkExtent2D extent) const override;
+    void clear_render_data() override;
+
+    void push_cloud_data(const kit::ref<const point_buffer_t> &points, glm::mat4 transform, std::uint32_t count,
+                         bool round);
+
+    bool sprites() const;
+
+    const char *name() const override;
+    std::size_t render_data_count() const override;
+
+  private:
+    std::array<std::vector<cloud_data>, frame_handoff::SLOTS> m_cloud_data;
+
+    void pipeline_config(pipeline::config_info &config) const override;
+};
+
+struct gpu_particle
+{
+    glm::vec4 position{0.f}; // w holds the remaining lifetime. Particles with no lifetime left are not rendered
+    glm::vec4 velocity{0.f}; // w holds the size in pixels
+    color color;
+
+    static std::vector<VkVertexInputBindingDescription> binding_descriptions();
+    static std::vector<VkVertexInputAttributeDescription> attribute_descriptions();
+};
+
+struct particle_compute_push_constant_data
+{
+    glm::vec4 gravity{0.f};
+    float dt = 0.f;
+    float damping = 0.f;
+    std::uint32_t count = 0;
+};
+
+// Particles live in storage buffers that are integrated by a compute shader before the render pass and then rendered
+// straight from the same buffer as instanced quads, so their state never goes back to the cpu
+template <Dimension Dim> class particle_render_system final : public render_system<Dim>
+{
+  public:
+    using camera_t = typename Dim::camera_t;
+
+    struct particle_data
+    {
+        kit::ref<const buffer> particles;
+        glm::mat4 mdl_transform;
+        std::uint32_t count;
+        kit::ref<std::atomic<float>> pending_dt;
+        glm::vec4 gravity;
+        float damping;
+        bool round;
+    };
+
+    static inline constexpr std::uint32_t WORKGROUP_SIZE = 64;
+
+    void init(const kit::ref<const device> &dev, VkRenderPass render_pass) override;
+    void dispatch(VkCommandBuffer command_buffer, std::uint32_t frame_index) const override;
+    void render(VkCommandBuffer command_buffer, const camera_t &cam, VkExtent2D extent) const override;
+    void clear_render_data() override;
+
+    void push_particle_data(const kit::ref<const buffer> &particles, glm::mat4 transform, std::uint32_t count,
+                            const kit::ref<std::atomic<float>> &pending_dt, const glm::vec4 &gravity, float damping,
+                            bool round);
+
+    const char *name() const override;
+    std::size_t render_data_count() const override;
+
+  private:
+    std::array<std::vector<particle_data>, frame_handoff::SLOTS> m_particle_data;
+    kit::scope<compute_pipeline> m_compute_pipeline;
+    mutable std::array<std::vector<VkDescriptorSet>, swap_chain::MAX_FRAMES_IN_FLIGHT> m_descriptor_sets;
+
+    void pipeline_config(pipeline::config_info &config) const override;
+};
+
+using thick_line_render_system2D = thick_line_render_system<dimension::two>;
+using thick_line_render_system3D = thick_line_render_system<dimension::three>;
+
+using trail_render_system2D = trail_render_system<dimension::two>;
+using trail_render_system3D = trail_render_system<dimension::three>;
+
+using point_cloud_render_system2D = point_cloud_render_system<dimension::two>;
+using point_cloud_render_system3D = point_cloud_render_system<dimension::three>;
+
+using particle_render_system2D = particle_render_system<dimension::two>;
+using particle_render_system3D = particle_render_system<dimension::three>;
 } // namespace lynx
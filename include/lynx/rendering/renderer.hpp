@@ -1,6 +1,9 @@
 #pragma once
 
 #include "lynx/rendering/swap_chain.hpp"
+#include "lynx/rendering/frame_capture.hpp"
+#include "lynx/rendering/gpu_profiler.hpp"
+#include "lynx/rendering/dynamic_resolution.hpp"
 #include "lynx/drawing/color.hpp"
 #include "lynx/internal/dimension.hpp"
 #include "lynx/rendering/device.hpp"
@@ -18,7 +21,7 @@ template <Dimension Dim> class renderer : kit::non_copyable
   public:
     using window_t = window<Dim>;
 
-    renderer(const kit::ref<const device> &dev, window_t &win);
+    renderer(const kit::ref<const device> &dev, window_t &win, const lynx::swap_chain::config_info &config = {});
     ~renderer();
 
     VkCommandBuffer begin_frame();
@@ -26,6 +29,9 @@ template <Dimension Dim> class renderer : kit::non_copyable
 
     void begin_swap_chain_render_pass(VkCommandBuffer command_buffer, const color &clear_color);
     void end_swap_chain_render_pass(VkCommandBuffer command_buffer);
+    // Must be called between the scene and any overlay drawn at native resolution. With dynamic resolution it upscales
+    // the scene into the swap chain image and begins the composite pass. It does nothing otherwise
+    void composite_scene(VkCommandBuffer command_buffer);
 
     template <kit::Callable<VkCommandBuffer> F> void immediate_submission(F submission) const
     {
@@ -34,6 +40,32 @@ template <Dimension Dim> class renderer : kit::non_copyable
         m_device->end_single_time_commands(command_buffer);
     }
 
+    void start_capture(const frame_capture::specs &spc);
+    void start_capture(frame_capture::callback on_frame);
+    void stop_capture();
+    bool capturing() const;
+
+    void enable_gpu_profiling(bool pipeline_statistics = false);
+    // Dynamic resolution must be disabled first, as it only updates from the profiler's frame times
+    void disable_gpu_profiling();
+    const lynx::gpu_profiler *gpu_profiler() const;
+
+    // Renders the scene at a scale that follows the gpu frame time against a budget (see dynamic_resolution). Gpu
+    // profiling is enabled if needed, as the controller is fed from it, and stays enabled once this is disabled
+    void enable_dynamic_resolution(const lynx::dynamic_resolution::specs &spc = {});
+    void disable_dynamic_resolution();
+    const lynx::dynamic_resolution *dynamic_resolution() const;
+    lynx::dynamic_resolution *dynamic_resolution();
+
+    // No-ops if gpu profiling is disabled
+    void begin_gpu_scope(VkCommandBuffer command_buffer, const char *name);
+    void end_gpu_scope(VkCommandBuffer command_buffer);
+
+    // Waits for the device and rebuilds the swap chain and the command buffers with the new configuration. Cannot be
+    // called while a frame is in progress
+    void reconfigure(const lynx::swap_chain::config_info &config);
+    std::uint32_t frames_in_flight() const;
+
     bool frame_in_progress() const;
     VkCommandBuffer current_command_buffer() const;
     std::uint32_t frame_index() const;
@@ -43,15 +75,24 @@ template <Dimension Dim> class renderer : kit::non_copyable
     window_t &m_window;
     kit::ref<const device> m_device;
     kit::scope<lynx::swap_chain> m_swap_chain;
-    std::array<VkCommandBuffer, swap_chain::MAX_FRAMES_IN_FLIGHT> m_command_buffers;
+    std::vector<VkCommandBuffer> m_command_buffers;
+    kit::scope<frame_capture> m_capture;
+    kit::scope<lynx::gpu_profiler> m_gpu_profiler;
+    kit::scope<lynx::dynamic_resolution> m_dynamic_resolution;
+    std::array<std::uint64_t, swap_chain::MAX_FRAMES_IN_FLIGHT> m_submit_times{};
+    std::array<std::uint32_t, swap_chain::MAX_FRAMES_IN_FLIGHT> m_scale_generations{};
 
     std::uint32_t m_image_index;
     std::uint32_t m_frame_index = 0;
     bool m_frame_started = false;
+    bool m_swap_chain_stale = false;
+    lynx::swap_chain::config_info m_config;
 
-    void create_command_buffers();
-    void create_swap_chain();
+    void create_command_buffers(std::uint32_t count);
+    bool create_swap_chain(const lynx::swap_chain::config_info &config);
     void free_command_buffers();
+    void begin_render_pass(VkRenderPass render_pass, VkFramebuffer frame_buffer, VkExtent2D extent,
+                           const VkClearColorValue &clear_color);
 };
 
 using renderer2D = renderer<dimension::two>;
@@ -13,16 +13,33 @@
 namespace lynx
 {
 
+// When the device is headless, the swap chain renders into its own offscreen images (one per frame in flight) instead,
+// leaving them in the transfer source layout, and never presents. With the null backend no image is created at all.
+// A swap chain created from an old one keeps it alive until every frame submitted with it has completed, instead of
+// waiting for the whole device to go idle
 class swap_chain : kit::non_copyable
 {
   public:
-    static constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 2;
-
-    swap_chain(const kit::ref<const device> &dev, VkExtent2D window_extentm, kit::scope<swap_chain> old_swap_chain);
+    // Upper bound for the number of frames in flight. Per frame resources elsewhere are sized with it
+    static constexpr std::uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+    // The automatic present mode (MAX_ENUM) prefers mailbox, then immediate, then FIFO. A requested mode the surface
+    // does not support falls back to FIFO, which is always available. An image count of 0 asks for one image more
+    // than the surface minimum; any count is clamped to the surface limits
+    struct config_info
+    {
+        VkPresentModeKHR present_mode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+        std::uint32_t image_count = 0;
+        std::uint32_t frames_in_flight = 2;
+    };
+
+    swap_chain(const kit::ref<const device> &dev, VkExtent2D window_extent, const config_info &config,
+               kit::scope<swap_chain> old_swap_chain);
     ~swap_chain();
 
     VkFramebuffer frame_buffer(std::size_t index) const;
     VkRenderPass render_pass() const;
+    VkImage image(std::size_t index) const;
     VkImageView image_view(std::size_t index) const;
     std::size_t image_count() const;
     VkFormat swap_chain_image_format() const;
@@ -30,24 +47,38 @@ class swap_chain : kit::non_copyable
     std::uint32_t width() const;
     std::uint32_t height() const;
     float extent_aspect_ratio() const;
+    bool capturable() const;
+    // Whether the images can be blit into, which dynamic resolution needs
+    bool upscalable() const;
+
+    const config_info &config() const;
+    std::uint32_t frames_in_flight() const;
+    // The mode actually in use, which may differ from the requested one
+    VkPresentModeKHR present_mode() const;
 
     VkFormat find_depth_format() const;
 
-    VkResult acquire_next_image(std::uint32_t *image_index) const;
+    VkResult acquire_next_image(std::uint32_t *image_index);
     VkResult submit_command_buffers(const VkCommandBuffer *buffers, const std::uint32_t *image_index);
 
   private:
     void init();
+    void init_null_backend();
+    void create_offscreen_images();
     void create_image_views();
     void create_depth_resources();
     void create_render_pass();
     void create_frame_buffers();
     void create_sync_objects();
 
+    void retire_old_swap_chain();
+    bool frames_completed() const;
+
     bool compare_swap_formats(const swap_chain &swpc) const;
 
     VkSurfaceFormatKHR choose_swap_surface_format(const std::vector<VkSurfaceFormatKHR> &available_formats);
-    VkPresentModeKHR choose_swap_present_mode(const std::vector<VkPresentModeKHR> &available_present_modes);
+    VkPresentModeKHR choose_swap_present_mode(const std::vector<VkPresentModeKHR> &available_present_modes) const;
+    std::uint32_t choose_image_count(const VkSurfaceCapabilitiesKHR &capabilities) const;
     VkExtent2D choose_swap_extent(const VkSurfaceCapabilitiesKHR &capabilities);
 
     VkFormat m_swap_chain_image_format;
@@ -57,22 +88,29 @@ class swap_chain : kit::non_copyable
     std::vector<VkFramebuffer> m_swap_chain_frame_buffers;
     VkRenderPass m_render_pass;
 
-    std::vector<VkImage> m_depth_images;
-    std::vector<VkDeviceMemory> m_depth_image_memories;
-    std::vector<VkImageView> m_depth_image_views;
+    // A single depth attachment serves every frame buffer: it is cleared on load and never stored, and the render pass
+    // dependency orders each frame's depth writes after the previous frame's
+    VkImage m_depth_image = VK_NULL_HANDLE;
+    VkDeviceMemory m_depth_image_memory = VK_NULL_HANDLE;
+    VkImageView m_depth_image_view = VK_NULL_HANDLE;
     std::vector<VkImage> m_swap_chain_images;
     std::vector<VkImageView> m_swap_chain_image_views;
+    std::vector<VkDeviceMemory> m_offscreen_image_memories;
 
     kit::ref<const device> m_device;
     kit::scope<swap_chain> m_old_swap_chain;
 
     VkExtent2D m_window_extent;
+    config_info m_config;
+    VkPresentModeKHR m_present_mode = VK_PRESENT_MODE_FIFO_KHR;
 
-    VkSwapchainKHR m_swap_chain;
+    VkSwapchainKHR m_swap_chain = VK_NULL_HANDLE;
+    bool m_capturable = true;
+    bool m_upscalable = true;
 
-    std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_image_available_semaphores;
-    std::array<VkSemaphore, MAX_FRAMES_IN_FLIGHT> m_render_finished_semaphores;
-    std::array<VkFence, MAX_FRAMES_IN_FLIGHT> m_in_flight_fences;
+    std::vector<VkSemaphore> m_image_available_semaphores;
+    std::vector<VkSemaphore> m_render_finished_semaphores;
+    std::vector<VkFence> m_in_flight_fences;
     std::vector<VkFence> m_images_in_flight;
     std::size_t m_current_frame = 0;
 };
@@ -14,4 +14,17 @@ mkdir -p "$DIR/../shaders/bin"
 /usr/local/bin/glslc "$DIR/../shaders/shader2D.frag" -o "$DIR/../shaders/bin/shader2D.frag.spv"
 
 /usr/local/bin/glslc "$DIR/../shaders/shader3D.vert" -o "$DIR/../shaders/bin/shader3D.vert.spv"
-/usr/local/bin/glslc "$DIR/../shaders/shader3D.frag" -o "$DIR/../shaders/bin/shader3D.frag.spv"
\ No newline at end of file
+/usr/local/bin/glslc "$DIR/../shaders/shader3D.frag" -o "$DIR/../shaders/bin/shader3D.frag.spv"
+/usr/local/bin/glslc "$DIR/../shaders/thick_line.vert" -o "$DIR/../shaders/bin/thick_line.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/thick_line.frag" -o "$DIR/../shaders/bin/thick_line.frag.spv"
+
+/usr/local/bin/glslc "$DIR/../shaders/trail2D.vert" -o "$DIR/../shaders/bin/trail2D.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/trail3D.vert" -o "$DIR/../shaders/bin/trail3D.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/trail.frag" -o "$DIR/../shaders/bin/trail.frag.spv"
+
+/usr/local/bin/glslc "$DIR/../shaders/point_cloud.vert" -o "$DIR/../shaders/bin/point_cloud.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/point_sprite.vert" -o "$DIR/../shaders/bin/point_sprite.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/point_cloud.frag" -o "$DIR/../shaders/bin/point_cloud.frag.spv"
+
+/usr/local/bin/glslc "$DIR/../shaders/particle.vert" -o "$DIR/../shaders/bin/particle.vert.spv"
+/usr/local/bin/glslc "$DIR/../shaders/particle.comp" -o "$DIR/../shaders/bin/particle.comp.spv"
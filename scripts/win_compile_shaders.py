@@ -4,6 +4,24 @@ import sys
 from pathlib import Path
 
 
+SHADERS = [
+    "shader2D.vert",
+    "shader2D.frag",
+    "shader3D.vert",
+    "shader3D.frag",
+    "thick_line.vert",
+    "thick_line.frag",
+    "trail2D.vert",
+    "trail3D.vert",
+    "trail.frag",
+    "point_cloud.vert",
+    "point_sprite.vert",
+    "point_cloud.frag",
+    "particle.vert",
+    "particle.comp",
+]
+
+
 class VulkanNotInstalledError(Exception):
     pass
 
@@ -19,17 +37,16 @@ def main() -> None:
     shader_folder = Path(__file__).parent.parent / "shaders"
     (shader_folder / "bin").mkdir(exist_ok=True)
 
-    for shader in ["vert", "frag"]:
-        for dim in ["2D", "3D"]:
-            subprocess.run(
-                [
-                    "glslc.exe",
-                    str(shader_folder / f"shader{dim}.{shader}"),
-                    "-o",
-                    str(shader_folder / "bin" / f"shader{dim}.{shader}.spv"),
-                ],
-                check=True,
-            )
+    for name in SHADERS:
+        subprocess.run(
+            [
+                "glslc.exe",
+                str(shader_folder / name),
+                "-o",
+                str(shader_folder / "bin" / f"{name}.spv"),
+            ],
+            check=True,
+        )
 
 
 if __name__ == "__main__":
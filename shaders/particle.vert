@@ -0,0 +1,37 @@
+#version 450
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 velocity;
+layout(location = 2) in vec4 color;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) noperspective out vec2 frag_local;
+
+layout(push_constant) uniform Push
+{
+    mat4 transform;
+    vec2 viewport;
+    uint sprites;
+    uint round;
+}
+push;
+
+const vec2 CORNERS[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0), vec2(1.0, 1.0));
+
+void main()
+{
+    vec2 corner = CORNERS[gl_VertexIndex];
+    frag_color = color;
+    frag_local = corner;
+
+    // Dead particles are collapsed outside of the clip volume
+    if (position.w <= 0.0)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    vec4 clip = push.transform * vec4(position.xyz, 1.0);
+    gl_Position = clip;
+    gl_Position.xy += corner * velocity.w * clip.w / push.viewport;
+}
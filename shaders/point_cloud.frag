@@ -0,0 +1,26 @@
+#version 450
+
+layout(location = 0) in vec4 frag_color;
+layout(location = 1) noperspective in vec2 frag_local;
+
+layout(location = 0) out vec4 out_color;
+
+layout(push_constant) uniform Push
+{
+    mat4 transform;
+    vec2 viewport;
+    uint sprites;
+    uint round;
+}
+push;
+
+void main()
+{
+    if (push.round != 0)
+    {
+        vec2 local = push.sprites != 0 ? frag_local : 2.0 * gl_PointCoord - 1.0;
+        if (dot(local, local) > 1.0)
+            discard;
+    }
+    out_color = frag_color;
+}
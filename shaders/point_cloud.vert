@@ -0,0 +1,26 @@
+#version 450
+
+// 2D positions are fed through a two component format, so z is filled with 0 by the vertex input stage
+layout(location = 0) in vec3 position;
+layout(location = 1) in float size;
+layout(location = 2) in vec4 color;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) noperspective out vec2 frag_local;
+
+layout(push_constant) uniform Push
+{
+    mat4 transform;
+    vec2 viewport;
+    uint sprites;
+    uint round;
+}
+push;
+
+void main()
+{
+    gl_Position = push.transform * vec4(position, 1.0);
+    gl_PointSize = size;
+    frag_color = color;
+    frag_local = vec2(0.0);
+}
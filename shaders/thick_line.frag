@@ -0,0 +1,22 @@
+#version 450
+
+layout(location = 0) in vec4 frag_color;
+layout(location = 1) noperspective in vec2 frag_local;
+layout(location = 2) flat in float frag_length;
+layout(location = 3) flat in float frag_half_width;
+layout(location = 4) flat in uint frag_join;
+
+layout(location = 0) out vec4 out_color;
+
+const uint JOIN_ROUND = 2;
+
+void main()
+{
+    if (frag_join == JOIN_ROUND)
+    {
+        float along = clamp(frag_local.x, 0.0, frag_length);
+        if (distance(frag_local, vec2(along, 0.0)) > frag_half_width)
+            discard;
+    }
+    out_color = frag_color;
+}
@@ -0,0 +1,97 @@
+#version 450
+
+layout(location = 0) in vec3 p0;
+layout(location = 1) in vec3 p1;
+layout(location = 2) in vec3 p2;
+layout(location = 3) in vec3 p3;
+layout(location = 4) in float width;
+layout(location = 5) in vec4 color;
+layout(location = 6) in uint join;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) noperspective out vec2 frag_local;
+layout(location = 2) flat out float frag_length;
+layout(location = 3) flat out float frag_half_width;
+layout(location = 4) flat out uint frag_join;
+
+layout(push_constant) uniform Push
+{
+    mat4 projection;
+    vec2 viewport;
+}
+push;
+
+const uint JOIN_MITER = 1;
+const uint JOIN_ROUND = 2;
+const float MITER_LIMIT = 4.0;
+
+vec2 to_screen(vec4 clip)
+{
+    return 0.5 * push.viewport * clip.xy / clip.w;
+}
+
+vec2 direction(vec2 from, vec2 to)
+{
+    vec2 delta = to - from;
+    float len = length(delta);
+    return len > 0.0 ? delta / len : vec2(0.0);
+}
+
+vec2 miter_offset(vec2 dir, vec2 neighbour_dir, vec2 normal, float half_width)
+{
+    vec2 tangent = dir + neighbour_dir;
+    if (dot(tangent, tangent) < 1e-6)
+        return normal * half_width;
+
+    tangent = normalize(tangent);
+    vec2 miter = vec2(-tangent.y, tangent.x);
+    return miter * half_width / max(dot(miter, normal), 1.0 / MITER_LIMIT);
+}
+
+void main()
+{
+    vec4 c1 = push.projection * vec4(p1, 1.0);
+    vec4 c2 = push.projection * vec4(p2, 1.0);
+
+    vec2 s1 = to_screen(c1);
+    vec2 s2 = to_screen(c2);
+
+    float len = length(s2 - s1);
+    vec2 dir = len > 0.0 ? (s2 - s1) / len : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+    float half_width = 0.5 * width;
+
+    bool at_end = gl_VertexIndex >= 2;
+    float side = gl_VertexIndex % 2 == 0 ? -1.0 : 1.0;
+
+    vec2 offset;
+    float along;
+    if (join == JOIN_ROUND)
+    {
+        // The quad is extended by half the width on both ends and the fragment shader carves out a capsule
+        along = at_end ? len + half_width : -half_width;
+        offset = dir * (at_end ? half_width : -half_width) + normal * half_width * side;
+    }
+    else if (join == JOIN_MITER)
+    {
+        along = at_end ? len : 0.0;
+        vec2 neighbour_dir = at_end ? direction(s2, to_screen(push.projection * vec4(p3, 1.0)))
+                                    : direction(to_screen(push.projection * vec4(p0, 1.0)), s1);
+        offset = side * miter_offset(dir, neighbour_dir, normal, half_width);
+    }
+    else
+    {
+        along = at_end ? len : 0.0;
+        offset = normal * half_width * side;
+    }
+
+    vec4 clip = at_end ? c2 : c1;
+    vec2 screen = (at_end ? s2 : s1) + offset;
+    gl_Position = vec4(2.0 * screen * clip.w / push.viewport, clip.z, clip.w);
+
+    frag_color = color;
+    frag_local = vec2(along, half_width * side);
+    frag_length = len;
+    frag_half_width = half_width;
+    frag_join = join;
+}
@@ -0,0 +1,28 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+
+layout(location = 0) out vec4 frag_color;
+
+layout(push_constant) uniform Push
+{
+    mat4 transform;
+    uint start;
+    uint count;
+    uint capacity;
+    uint fade;
+}
+push;
+
+void main()
+{
+    gl_Position = push.transform * vec4(position, 1.0);
+    frag_color = color;
+    if (push.fade != 0)
+    {
+        // Index capacity mirrors index 0, so both map to the same age
+        uint age_index = (uint(gl_VertexIndex) + push.capacity - push.start) % push.capacity;
+        frag_color.a *= float(age_index + 1) / float(push.count);
+    }
+}
@@ -3,10 +3,13 @@
 #include "lynx/geometry/camera.hpp"
 #include "lynx/serialization/serialization.hpp"
 
+#include <algorithm>
+
 namespace lynx
 {
 template <Dimension Dim> app<Dim>::app(const typename window_t::specs &spc) : m_window(kit::make_scope<window_t>(spc))
 {
+    m_window->jobs(&m_jobs);
 }
 
 template <Dimension Dim> app<Dim>::~app()
@@ -31,13 +34,16 @@ template <Dimension Dim> void app<Dim>::start()
     m_started = true;
     context_t::set(m_window.get());
 #ifdef LYNX_ENABLE_IMGUI
-    imgui_init();
+    if (!m_window->headless())
+        imgui_init();
 #endif
     on_start();
     for (const auto &ly : m_layers)
         if (ly->enabled()) [[likely]]
             ly->on_start();
     on_late_start();
+    if (m_window->threaded_rendering())
+        start_render_thread();
     m_state = state::NONE;
 }
 
@@ -45,85 +51,248 @@ template <Dimension Dim> bool app<Dim>::next_frame()
 {
     KIT_ASSERT_ERROR(!m_terminated, "Cannot fetch next frame on a terminated app")
     KIT_ASSERT_ERROR(m_started, "App must be started first by calling start() before fetching the next frame")
-    KIT_PERF_SCOPE("lynx::app::next_frame")
-
-    if (m_min_frame_time > m_frame_time)
-    {
-        kit::perf::time::sleep(m_min_frame_time - m_frame_time);
-        m_frame_time = m_min_frame_time;
-    }
-    const kit::perf::clock frame_clock;
+    trace::mark_frame();
+    LYNX_TRACE_SCOPE("lynx::app::next_frame")
+
+    // Time spent idle is neither a missed deadline nor part of the frame time, which keeps the previous value
+    const bool idled = m_idle_mode && !m_fast_forward && wait_for_redraw();
+    if (idled)
+        m_pacer.reset();
+
+    // The frame time spans from the previous frame's start to this one's, so that it includes the pacing wait
+    const frame_pacer::clock::time_point frame_start = m_fast_forward ? frame_pacer::clock::now() : m_pacer.wait();
+    const bool present = should_present();
+    if (m_last_frame_start != frame_pacer::clock::time_point{} && !idled)
+        m_frame_time = kit::perf::time::from<kit::perf::time::seconds>(
+            std::chrono::duration<float>(frame_start - m_last_frame_start).count());
+    m_last_frame_start = frame_start;
     m_ongoing_frame = true;
+    m_jobs.reset_scratch();
 
     context_t::set(m_window.get());
-    input_t::poll_events();
+    if (!m_window->headless() && present)
+        input_t::poll_events();
+    // The render thread may still be presenting to the window, which is destroyed as soon as it is found closed
+    if (m_window->should_close())
+        stop_render_thread();
     if (m_window->closed())
     {
         m_ongoing_frame = false;
         return false;
     }
+    m_window->suspend_drawing(!present);
 
     m_state = state::EVENT_PROCESSING;
     while (const event ev = m_window->poll_event())
+    {
+        // ImGui needs a couple of frames to settle hover and focus changes after input
+        if (m_idle_mode)
+            schedule_redraw(3);
         if (!on_event(ev))
         {
             for (auto it = m_layers.rbegin(); it != m_layers.rend(); ++it)
-                if ((*it)->enabled() && (*it)->on_event(ev))
+            {
+                if (!(*it)->enabled())
+                    continue;
+                bool handled;
+                time_layer((*it)->m_timings.event, [&] { handled = (*it)->on_event(ev); });
+                if (handled)
                     break;
+            }
             on_late_event(ev);
         }
+    }
 
     const float delta_time = m_frame_time.as<kit::perf::time::seconds, float>();
     m_state = state::UPDATING;
     {
-        KIT_PERF_SCOPE("lynx::app::on_update") // MARK PERF SCOPES WITH LYNX/PPX-APP WHATEVER
+        LYNX_TRACE_SCOPE("lynx::app::on_update")
 
         const kit::perf::clock update_clock;
 
+        if (m_fixed_timestep > 0.f)
+        {
+            LYNX_TRACE_SCOPE("lynx::app::on_fixed_update")
+            m_accumulator = std::min(m_accumulator + delta_time, m_fixed_timestep * (float)m_max_fixed_steps);
+            while (m_accumulator >= m_fixed_timestep)
+            {
+                on_fixed_update(m_fixed_timestep);
+                update_layers([this](layer_t &ly) {
+                    time_layer(ly.m_timings.update, [&] { ly.on_fixed_update(m_fixed_timestep); });
+                });
+                m_accumulator -= m_fixed_timestep;
+            }
+        }
+
         on_update(delta_time);
-        for (const auto &ly : m_layers)
-            if (ly->enabled()) [[likely]]
-                ly->on_update(delta_time);
+        update_layers([this, delta_time](layer_t &ly) {
+            time_layer(ly.m_timings.update, [&] { ly.on_update(delta_time); });
+        });
         on_late_update(delta_time);
         m_update_time = update_clock.elapsed();
     }
 
+    if (present)
+        render_frame(delta_time);
+    else
+        m_window->discard_frame();
+    m_window->suspend_drawing(false);
+
+    std::uint32_t frames = m_redraw_frames.load(std::memory_order_relaxed);
+    while (frames > 0 && !m_redraw_frames.compare_exchange_weak(frames, frames - 1, std::memory_order_relaxed))
+        ;
+
+    m_ongoing_frame = false;
+    if (m_layer_timing)
+        for (const auto &ly : m_layers)
+            ly->m_timings.commit();
+
+    return !m_window->closed() && !m_to_finish_next_frame;
+}
+
+template <Dimension Dim> void app<Dim>::render_frame(const float ts)
+{
     m_state = state::RENDERING;
 #ifdef LYNX_ENABLE_IMGUI
-    imgui_begin_render();
+    if (!m_window->headless())
+        imgui_begin_render();
 #endif
 
     {
-        KIT_PERF_SCOPE("lynx::app::on_render")
+        LYNX_TRACE_SCOPE("lynx::app::on_render")
         const kit::perf::clock render_clock;
 
-        on_render(delta_time);
+        on_render(ts);
         for (const auto &ly : m_layers)
             if (ly->enabled()) [[likely]]
-                ly->on_render(delta_time);
-        on_late_render(delta_time);
+                time_layer(ly->m_timings.render, [&] { ly->on_render(ts); });
+        on_late_render(ts);
         m_render_time = render_clock.elapsed();
     }
 
 #ifdef LYNX_ENABLE_IMGUI
-    imgui_end_render();
+    if (!m_window->headless())
+        imgui_end_render();
 #endif
 
-    const auto submission = [this](const VkCommandBuffer cmd) {
 #ifdef LYNX_ENABLE_IMGUI
-        imgui_submit_command(cmd);
+    if (m_window->threaded_rendering() && !m_window->headless())
+        m_imgui_snapshots[m_window->handoff().record_slot()].capture(ImGui::GetDrawData());
 #endif
+    if (m_window->threaded_rendering())
+    {
+        m_window->publish_frame();
+        return;
+    }
+
+    const auto submission = [this](const VkCommandBuffer cmd) { submit_commands(cmd); };
+    // A frame is skipped while the window is minimized or its swap chain is out of date
+    m_window->display(submission);
+    if (m_align_to_presentation)
+        m_pacer.align(frame_pacer::clock::now());
+}
+
+// Each layer waits on every earlier layer it conflicts with, which keeps their relative order and makes the graph
+// acyclic. Each layer only ever runs in one job at a time, so its timings need no synchronization
+template <Dimension Dim> void app<Dim>::update_layers(const std::function<void(layer_t &)> &update)
+{
+    if (!m_parallel_updates)
+    {
         for (const auto &ly : m_layers)
             if (ly->enabled()) [[likely]]
-                ly->on_command_submission(cmd);
-    };
-    KIT_CHECK_RETURN_VALUE(m_window->display(submission), true, CRITICAL,
-                           "Display failed to get command buffer for new frame")
+                update(*ly);
+        return;
+    }
 
-    m_ongoing_frame = false;
+    LYNX_TRACE_SCOPE("lynx::app::update_layers")
+    std::vector<job_system::handle> jobs(m_layers.size());
+    std::vector<job_system::handle> dependencies;
+    for (std::size_t i = 0; i < m_layers.size(); i++)
+    {
+        layer_t &ly = *m_layers[i];
+        if (!ly.enabled())
+            continue;
+        dependencies.clear();
+        for (std::size_t j = 0; j < i; j++)
+            if (jobs[j] && ly.conflicts_with(*m_layers[j]))
+                dependencies.push_back(jobs[j]);
+        jobs[i] = m_jobs.submit("lynx::app::update_layer", [&update, &ly] { update(ly); }, dependencies);
+    }
+    for (const job_system::handle &jb : jobs)
+        if (jb)
+            m_jobs.wait(jb);
+}
 
-    m_frame_time = frame_clock.elapsed();
-    return !m_window->closed() && !m_to_finish_next_frame;
+template <Dimension Dim> void app<Dim>::parallel_updates(const bool enabled)
+{
+    m_parallel_updates = enabled;
+}
+template <Dimension Dim> bool app<Dim>::parallel_updates() const
+{
+    return m_parallel_updates;
+}
+
+template <Dimension Dim> void app<Dim>::submit_commands(const VkCommandBuffer command_buffer)
+{
+    renderer<Dim> &rnd = m_window->renderer();
+#ifdef LYNX_ENABLE_IMGUI
+    if (!m_window->headless())
+    {
+        rnd.begin_gpu_scope(command_buffer, "imgui");
+        imgui_submit_command(command_buffer);
+        rnd.end_gpu_scope(command_buffer);
+    }
+#endif
+    // Layer timings are collected and committed by the update thread, so submissions from the render thread go untimed
+    const bool threaded = m_window->threaded_rendering();
+    for (const auto &ly : m_layers)
+        if (ly->enabled()) [[likely]]
+        {
+            rnd.begin_gpu_scope(command_buffer, ly->id().c_str());
+            if (threaded)
+                ly->on_command_submission(command_buffer);
+            else
+                time_layer(ly->m_timings.submission, [&] { ly->on_command_submission(command_buffer); });
+            rnd.end_gpu_scope(command_buffer);
+        }
+}
+
+template <Dimension Dim> void app<Dim>::threaded_rendering(const bool enabled)
+{
+    KIT_ASSERT_ERROR(!m_ongoing_frame, "Threaded rendering can only be toggled between frames")
+    if (enabled == m_window->threaded_rendering())
+        return;
+    if (!enabled)
+        stop_render_thread();
+    m_window->threaded_rendering(enabled);
+    if (enabled && m_started && !m_terminated)
+        start_render_thread();
+}
+template <Dimension Dim> bool app<Dim>::threaded_rendering() const
+{
+    return m_window->threaded_rendering();
+}
+
+template <Dimension Dim> void app<Dim>::render_loop()
+{
+    const auto submission = [this](const VkCommandBuffer cmd) { submit_commands(cmd); };
+    while (m_window->acquire_frame())
+        m_window->display(submission);
+}
+
+template <Dimension Dim> void app<Dim>::start_render_thread()
+{
+    KIT_ASSERT_ERROR(!m_render_thread.joinable(), "The render thread is already running")
+    m_render_thread = std::thread(&app::render_loop, this);
+}
+
+// Frames published but not yet rendered are dropped. The window clears them when threaded rendering is toggled
+template <Dimension Dim> void app<Dim>::stop_render_thread()
+{
+    if (!m_render_thread.joinable())
+        return;
+    m_window->handoff().stop();
+    m_render_thread.join();
 }
 
 template <Dimension Dim> const char *app<Dim>::name() const
@@ -141,6 +310,7 @@ template <Dimension Dim> void app<Dim>::shutdown()
         return;
     }
     KIT_ASSERT_ERROR(!m_terminated, "Cannot terminate an already terminated app")
+    stop_render_thread();
     m_window->wait_for_device();
 
     on_shutdown();
@@ -150,7 +320,8 @@ template <Dimension Dim> void app<Dim>::shutdown()
     on_late_shutdown();
 
 #ifdef LYNX_ENABLE_IMGUI
-    imgui_shutdown();
+    if (!m_window->headless())
+        imgui_shutdown();
 #endif
 
     m_terminated = true;
@@ -171,6 +342,15 @@ template <Dimension Dim> window<Dim> *app<Dim>::window()
     return m_window.get();
 }
 
+template <Dimension Dim> const job_system &app<Dim>::jobs() const
+{
+    return m_jobs;
+}
+template <Dimension Dim> job_system &app<Dim>::jobs()
+{
+    return m_jobs;
+}
+
 template <Dimension Dim> kit::perf::time app<Dim>::frame_time() const
 {
     return m_frame_time;
@@ -220,13 +400,136 @@ template <Dimension Dim> std::uint32_t app<Dim>::framerate() const
 
 template <Dimension Dim> std::uint32_t app<Dim>::framerate_cap() const
 {
-    const bool capped = m_min_frame_time.as<kit::perf::time::nanoseconds, long long>() > 0;
-    return capped ? (std::uint32_t)(1.f / m_min_frame_time.as<kit::perf::time::seconds, float>()) : 0;
+    return m_pacer.framerate();
 }
 
 template <Dimension Dim> void app<Dim>::limit_framerate(const std::uint32_t framerate)
 {
-    m_min_frame_time = kit::perf::time::from<kit::perf::time::seconds>(framerate > 0 ? (1.f / framerate) : 0.f);
+    m_pacer.framerate(framerate);
+}
+
+template <Dimension Dim> const frame_pacer &app<Dim>::pacer() const
+{
+    return m_pacer;
+}
+template <Dimension Dim> frame_pacer &app<Dim>::pacer()
+{
+    return m_pacer;
+}
+template <Dimension Dim> void app<Dim>::align_to_presentation(const bool align)
+{
+    m_align_to_presentation = align;
+}
+
+template <Dimension Dim> void app<Dim>::fixed_timestep(const float seconds, const std::uint32_t max_steps)
+{
+    KIT_ASSERT_ERROR(seconds >= 0.f, "Fixed timestep must not be negative")
+    KIT_ASSERT_ERROR(max_steps > 0, "At least one fixed step per frame must be allowed")
+    m_fixed_timestep = seconds;
+    m_max_fixed_steps = max_steps;
+    m_accumulator = 0.f;
+}
+template <Dimension Dim> float app<Dim>::fixed_timestep() const
+{
+    return m_fixed_timestep;
+}
+template <Dimension Dim> float app<Dim>::interpolation_alpha() const
+{
+    return m_fixed_timestep > 0.f ? m_accumulator / m_fixed_timestep : 1.f;
+}
+
+template <Dimension Dim> void app<Dim>::fast_forward(const bool enabled, const std::uint32_t present_rate,
+                                                   const std::uint32_t present_interval)
+{
+    m_fast_forward = enabled;
+    m_present_rate = present_rate;
+    m_present_interval = present_interval;
+    m_frames_since_present = 0;
+    m_last_present = {};
+    if (!enabled)
+        m_pacer.reset();
+}
+template <Dimension Dim> bool app<Dim>::fast_forward() const
+{
+    return m_fast_forward;
+}
+
+template <Dimension Dim> bool app<Dim>::should_present()
+{
+    if (!m_fast_forward || (m_present_rate == 0 && m_present_interval == 0))
+        return true;
+
+    const frame_pacer::clock::time_point now = frame_pacer::clock::now();
+    const bool interval_reached = m_present_interval > 0 && ++m_frames_since_present >= m_present_interval;
+    const bool period_elapsed =
+        m_present_rate > 0 && std::chrono::duration<double>(now - m_last_present).count() * m_present_rate >= 1.0;
+    if (!interval_reached && !period_elapsed)
+        return false;
+
+    m_frames_since_present = 0;
+    m_last_present = now;
+    return true;
+}
+
+template <Dimension Dim> void app<Dim>::idle_mode(const bool enabled, const float timeout_seconds)
+{
+    KIT_ASSERT_ERROR(timeout_seconds >= 0.f, "Idle timeout must not be negative")
+    m_idle_mode = enabled;
+    m_idle_timeout = timeout_seconds;
+}
+template <Dimension Dim> bool app<Dim>::idle_mode() const
+{
+    return m_idle_mode;
+}
+
+template <Dimension Dim> void app<Dim>::request_redraw(const std::uint32_t frames)
+{
+    schedule_redraw(frames);
+    if (m_idle_mode && !m_window->headless())
+        glfwPostEmptyEvent();
+}
+template <Dimension Dim> void app<Dim>::schedule_redraw(const std::uint32_t frames)
+{
+    std::uint32_t current = m_redraw_frames.load(std::memory_order_relaxed);
+    while (current < frames && !m_redraw_frames.compare_exchange_weak(current, frames, std::memory_order_relaxed))
+        ;
+}
+
+template <Dimension Dim> void app<Dim>::animating(const bool animating)
+{
+    m_animating = animating;
+}
+template <Dimension Dim> bool app<Dim>::animating() const
+{
+    return m_animating;
+}
+
+template <Dimension Dim> bool app<Dim>::wait_for_redraw()
+{
+    if (m_window->headless() || m_animating || m_redraw_frames.load(std::memory_order_relaxed) > 0)
+        return false;
+
+    LYNX_TRACE_SCOPE("lynx::app::wait_for_redraw")
+    if (m_idle_timeout > 0.f)
+        glfwWaitEventsTimeout((double)m_idle_timeout);
+    else
+        glfwWaitEvents();
+    return true;
+}
+
+template <Dimension Dim> void app<Dim>::enable_layer_timing(const bool enabled)
+{
+    m_layer_timing = enabled;
+}
+template <Dimension Dim> bool app<Dim>::layer_timing_enabled() const
+{
+    return m_layer_timing;
+}
+template <Dimension Dim> const layer_timings &app<Dim>::layer_timing(const std::string &name) const
+{
+    const layer_t *ly = (*this)[name];
+    KIT_ASSERT_ERROR(ly, "No layer named {0} was found", name)
+    return ly->timings();
 }
 
 #ifdef LYNX_ENABLE_IMGUI
@@ -277,8 +580,11 @@ template <Dimension Dim> void app<Dim>::imgui_init()
     init_info.Device = m_window->device()->vulkan_device();
     init_info.Queue = m_window->device()->graphics_queue();
     init_info.DescriptorPool = m_imgui_pool;
-    init_info.MinImageCount = 3;
-    init_info.ImageCount = 3;
+    // ImGui cycles its per frame vertex buffers over ImageCount slots. Keeping at least as many slots as the maximum
+    // frames in flight lets the swap chain be reconfigured at runtime without reinitializing the backend
+    const std::uint32_t image_count = (std::uint32_t)m_window->renderer().swap_chain().image_count();
+    init_info.MinImageCount = 2;
+    init_info.ImageCount = std::max(image_count, swap_chain::MAX_FRAMES_IN_FLIGHT);
     init_info.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
 
     ImGui_ImplVulkan_Init(&init_info, m_window->renderer().swap_chain().render_pass());
@@ -291,7 +597,7 @@ template <Dimension Dim> void app<Dim>::imgui_init()
 
 template <Dimension Dim> void app<Dim>::imgui_begin_render()
 {
-    KIT_PERF_SCOPE("lynx::app::imgui_begin_render")
+    LYNX_TRACE_SCOPE("lynx::app::imgui_begin_render")
     ImGui::SetCurrentContext(m_imgui_context);
 #ifdef LYNX_ENABLE_IMPLOT
     ImPlot::SetCurrentContext(m_implot_context);
@@ -306,14 +612,19 @@ template <Dimension Dim> void app<Dim>::imgui_begin_render()
 
 template <Dimension Dim> void app<Dim>::imgui_end_render()
 {
-    KIT_PERF_SCOPE("lynx::app::imgui_end_render")
+    LYNX_TRACE_SCOPE("lynx::app::imgui_end_render")
     ImGui::PopID();
     ImGui::Render();
 }
 
 template <Dimension Dim> void app<Dim>::imgui_submit_command(const VkCommandBuffer command_buffer)
 {
-    KIT_PERF_SCOPE("lynx::app::imgui_submit_command")
+    LYNX_TRACE_SCOPE("lynx::app::imgui_submit_command")
+    if (m_window->threaded_rendering())
+    {
+        ImGui_ImplVulkan_RenderDrawData(&m_imgui_snapshots[m_window->handoff().render_slot()].data, command_buffer);
+        return;
+    }
     ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), command_buffer);
     if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
     {
@@ -324,6 +635,32 @@ template <Dimension Dim> void app<Dim>::imgui_submit_command(const VkCommandBuff
     }
 }
 
+template <Dimension Dim> app<Dim>::imgui_snapshot::~imgui_snapshot()
+{
+    clear();
+}
+
+template <Dimension Dim> void app<Dim>::imgui_snapshot::capture(const ImDrawData *source)
+{
+    clear();
+    data = *source;
+    for (int i = 0; i < source->CmdListsCount; i++)
+        lists.push_back(source->CmdLists[i]->CloneOutput());
+#if IMGUI_VERSION_NUM >= 18980
+    data.CmdLists = lists;
+#else
+    data.CmdLists = lists.Data;
+#endif
+}
+
+template <Dimension Dim> void app<Dim>::imgui_snapshot::clear()
+{
+    for (ImDrawList *list : lists)
+        IM_DELETE(list);
+    lists.clear();
+    data.Clear();
+}
+
 template <Dimension Dim> void app<Dim>::imgui_shutdown()
 {
     ImGui::SetCurrentContext(m_imgui_context);
@@ -331,6 +668,8 @@ template <Dimension Dim> void app<Dim>::imgui_shutdown()
     ImPlot::SetCurrentContext(m_implot_context);
 #endif
 
+    for (imgui_snapshot &snapshot : m_imgui_snapshots)
+        snapshot.clear();
     vkDestroyDescriptorPool(m_window->device()->vulkan_device(), m_imgui_pool, nullptr);
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
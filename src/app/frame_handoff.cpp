@@ -0,0 +1,73 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/app/frame_handoff.hpp"
+
+namespace lynx
+{
+std::uint32_t frame_handoff::record_slot() const
+{
+    return m_record_slot;
+}
+std::uint32_t frame_handoff::render_slot() const
+{
+    return m_render_slot;
+}
+
+std::uint32_t frame_handoff::publish()
+{
+    // A stop may land at any time, and must survive the swap
+    std::uint32_t previous = m_latest.load(std::memory_order_relaxed);
+    while (!m_latest.compare_exchange_weak(previous, m_record_slot | FRESH | (previous & STOPPED),
+                                           std::memory_order_acq_rel, std::memory_order_relaxed))
+        ;
+    m_record_slot = previous & SLOT_MASK;
+    if (previous & FRESH)
+        m_dropped_frames.fetch_add(1, std::memory_order_relaxed);
+    m_published_frames.fetch_add(1, std::memory_order_relaxed);
+    m_latest.notify_one();
+    return m_record_slot;
+}
+
+bool frame_handoff::acquire()
+{
+    std::uint32_t latest = m_latest.load(std::memory_order_acquire);
+    while (!(latest & (FRESH | STOPPED)))
+    {
+        m_latest.wait(latest, std::memory_order_acquire);
+        latest = m_latest.load(std::memory_order_acquire);
+    }
+
+    // Only the consumer clears the fresh bit, so the swap always picks up a fresh frame (maybe a newer one). It fails
+    // if the producer published or a stop landed meanwhile, and the stop bit is never overwritten
+    while (!(latest & STOPPED))
+        if (m_latest.compare_exchange_weak(latest, m_render_slot, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            m_render_slot = latest & SLOT_MASK;
+            return true;
+        }
+    return false;
+}
+
+void frame_handoff::stop()
+{
+    m_latest.fetch_or(STOPPED, std::memory_order_acq_rel);
+    m_latest.notify_all();
+}
+
+void frame_handoff::reset()
+{
+    m_latest.store(1, std::memory_order_release);
+    m_record_slot = 0;
+    m_render_slot = 2;
+    m_published_frames.store(0, std::memory_order_relaxed);
+    m_dropped_frames.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t frame_handoff::published_frames() const
+{
+    return m_published_frames.load(std::memory_order_relaxed);
+}
+std::uint64_t frame_handoff::dropped_frames() const
+{
+    return m_dropped_frames.load(std::memory_order_relaxed);
+}
+} // namespace lynx
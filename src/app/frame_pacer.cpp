@@ -0,0 +1,102 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/app/frame_pacer.hpp"
+
+#include <cmath>
+
+namespace lynx
+{
+frame_pacer::frame_pacer(const std::uint32_t framerate)
+{
+    this->framerate(framerate);
+}
+
+frame_pacer::clock::time_point frame_pacer::wait()
+{
+    LYNX_TRACE_SCOPE("lynx::frame_pacer::wait")
+    clock::time_point now = clock::now();
+    if (m_period == clock::duration::zero())
+    {
+        m_frame_start = now;
+        return now;
+    }
+
+    // First frame, or the previous one overran by more than a period: restart the schedule
+    if (m_deadline == clock::time_point{} || now - m_deadline > m_period)
+    {
+        if (m_deadline != clock::time_point{})
+        {
+            m_missed_deadlines++;
+            m_last_lateness = now - m_deadline;
+        }
+        m_deadline = now + m_period;
+        m_frame_start = now;
+        return now;
+    }
+
+    if (now > m_deadline)
+    {
+        m_missed_deadlines++;
+        m_last_lateness = now - m_deadline;
+        m_frame_start = now;
+        m_deadline += m_period;
+        return now;
+    }
+
+    if (m_deadline - now > m_spin_threshold)
+        std::this_thread::sleep_until(m_deadline - m_spin_threshold);
+    while ((now = clock::now()) < m_deadline)
+        std::this_thread::yield();
+
+    m_last_lateness = now - m_deadline;
+    m_frame_start = now;
+    m_deadline += m_period;
+    return now;
+}
+
+void frame_pacer::align(const clock::time_point presented)
+{
+    if (m_period == clock::duration::zero() || presented < m_frame_start)
+        return;
+    const clock::duration latency = presented - m_frame_start;
+    m_present_latency =
+        m_present_latency == clock::duration::zero() ? latency : (7 * m_present_latency + latency) / 8;
+    m_deadline = presented + m_period - std::min(m_present_latency, m_period);
+}
+
+void frame_pacer::reset()
+{
+    m_deadline = {};
+}
+
+std::uint32_t frame_pacer::framerate() const
+{
+    if (m_period == clock::duration::zero())
+        return 0;
+    return (std::uint32_t)std::llround(1.0 / std::chrono::duration<double>(m_period).count());
+}
+void frame_pacer::framerate(const std::uint32_t framerate)
+{
+    const std::chrono::duration<double> period{framerate > 0 ? 1.0 / framerate : 0.0};
+    m_period = std::chrono::duration_cast<clock::duration>(period);
+    m_deadline = {};
+    m_present_latency = clock::duration::zero();
+}
+
+frame_pacer::clock::duration frame_pacer::spin_threshold() const
+{
+    return m_spin_threshold;
+}
+void frame_pacer::spin_threshold(const clock::duration threshold)
+{
+    m_spin_threshold = threshold;
+}
+
+std::uint64_t frame_pacer::missed_deadlines() const
+{
+    return m_missed_deadlines;
+}
+frame_pacer::clock::duration frame_pacer::last_lateness() const
+{
+    return m_last_lateness;
+}
+} // namespace lynx
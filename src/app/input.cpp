@@ -20,7 +20,7 @@ template <Dimension Dim> bool input<Dim>::key_pressed(const key kc)
 }
 template <Dimension Dim> bool input<Dim>::key_pressed(const window_t &win, const key kc)
 {
-    return glfwGetKey(win.glfw_window(), (int)kc) == GLFW_PRESS;
+    return !win.headless() && glfwGetKey(win.glfw_window(), (int)kc) == GLFW_PRESS;
 }
 
 template <Dimension Dim> bool input<Dim>::key_released(const key kc)
@@ -33,7 +33,7 @@ template <Dimension Dim> bool input<Dim>::key_released(const key kc)
 }
 template <Dimension Dim> bool input<Dim>::key_released(const window_t &win, const key kc)
 {
-    return glfwGetKey(win.glfw_window(), (int)kc) == GLFW_RELEASE;
+    return win.headless() || glfwGetKey(win.glfw_window(), (int)kc) == GLFW_RELEASE;
 }
 
 template <Dimension Dim> bool input<Dim>::mouse_button_pressed(const mouse btn)
@@ -46,7 +46,7 @@ template <Dimension Dim> bool input<Dim>::mouse_button_pressed(const mouse btn)
 }
 template <Dimension Dim> bool input<Dim>::mouse_button_pressed(const window_t &win, const mouse btn)
 {
-    return glfwGetMouseButton(win.glfw_window(), (int)btn);
+    return !win.headless() && glfwGetMouseButton(win.glfw_window(), (int)btn);
 }
 
 template <Dimension Dim> glm::vec2 input<Dim>::mouse_position()
@@ -54,7 +54,7 @@ template <Dimension Dim> glm::vec2 input<Dim>::mouse_position()
     static glm::vec2 screen_mouse{0.f};
     const window_t *win = context_t::window();
     KIT_ASSERT_ERROR(context_t::valid(), "Trying to get input feedback with a non valid current context")
-    if (!win)
+    if (!win || win->headless())
         return screen_mouse;
 
     double x, y;
@@ -1,13 +1,108 @@
 #include "lynx/internal/pch.hpp"
 #include "lynx/serialization/serialization.hpp"
 #include "lynx/app/layer.hpp"
+#include "lynx/app/app.hpp"
+
+#include <algorithm>
 
 namespace lynx
 {
+void layer_timings::phase::add(const float milliseconds)
+{
+    m_accumulated += milliseconds;
+}
+
+void layer_timings::phase::commit()
+{
+    m_samples[m_head] = m_accumulated;
+    m_head = (m_head + 1) % SAMPLES;
+    m_size = std::min(m_size + 1, SAMPLES);
+    m_accumulated = 0.f;
+}
+
+float layer_timings::phase::last() const
+{
+    return m_size == 0 ? 0.f : m_samples[(m_head + SAMPLES - 1) % SAMPLES];
+}
+
+float layer_timings::phase::average() const
+{
+    if (m_size == 0)
+        return 0.f;
+    float sum = 0.f;
+    for (std::size_t i = 0; i < m_size; i++)
+        sum += m_samples[i];
+    return sum / (float)m_size;
+}
+
+float layer_timings::phase::max() const
+{
+    return m_size == 0 ? 0.f : *std::max_element(m_samples.begin(), m_samples.begin() + (std::ptrdiff_t)m_size);
+}
+
+void layer_timings::commit()
+{
+    update.commit();
+    render.commit();
+    event.commit();
+    submission.commit();
+}
+
 template <Dimension Dim> layer<Dim>::layer(const std::string &name) : kit::identifiable<std::string>(name)
 {
 }
 
+template <Dimension Dim> const layer_timings &layer<Dim>::timings() const
+{
+    return m_timings;
+}
+
+template <Dimension Dim> void layer<Dim>::request_redraw(const std::uint32_t frames) const
+{
+    KIT_ASSERT_ERROR(m_parent, "Cannot request a redraw from a layer that is not attached to an app")
+    m_parent->request_redraw(frames);
+}
+
+template <Dimension Dim> job_system &layer<Dim>::jobs() const
+{
+    KIT_ASSERT_ERROR(m_parent, "Cannot access the jobs of a layer that is not attached to an app")
+    return m_parent->jobs();
+}
+
+template <Dimension Dim> void layer<Dim>::reads(const std::string &resource)
+{
+    m_reads.push_back(resource);
+}
+template <Dimension Dim> void layer<Dim>::writes(const std::string &resource)
+{
+    m_writes.push_back(resource);
+}
+
+template <Dimension Dim> bool layer<Dim>::conflicts_with(const layer &other) const
+{
+    if (!declares_access() || !other.declares_access())
+        return true;
+    for (const std::string &resource : m_reads)
+        if (other.writes_to(resource))
+            return true;
+    for (const std::string &resource : other.m_reads)
+        if (writes_to(resource))
+            return true;
+    for (const std::string &resource : m_writes)
+        if (other.writes_to(resource))
+            return true;
+    return false;
+}
+
+template <Dimension Dim> bool layer<Dim>::declares_access() const
+{
+    return !m_reads.empty() || !m_writes.empty();
+}
+template <Dimension Dim> bool layer<Dim>::writes_to(const std::string &resource) const
+{
+    return resource == this->id() || std::find(m_writes.begin(), m_writes.end(), resource) != m_writes.end();
+}
+
 #ifdef KIT_USE_YAML_CPP
 template <Dimension Dim> YAML::Node layer<Dim>::encode() const
 {
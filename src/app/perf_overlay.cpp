@@ -0,0 +1,310 @@
+#include "lynx/internal/pch.hpp"
+#ifdef LYNX_ENABLE_IMGUI
+#include "lynx/app/perf_overlay.hpp"
+#include "lynx/app/app.hpp"
+
+#include <algorithm>
+
+namespace lynx
+{
+template <Dimension Dim> perf_overlay<Dim>::perf_overlay(const std::string &name) : layer<Dim>(name)
+{
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::ring::push(const float value)
+{
+    m_values[m_head] = value;
+    m_head = (m_head + 1) % SAMPLES;
+    m_size = std::min(m_size + 1, SAMPLES);
+}
+
+template <Dimension Dim> float perf_overlay<Dim>::ring::percentile(const float p) const
+{
+    if (m_size == 0)
+        return 0.f;
+    std::array<float, SAMPLES> sorted;
+    std::copy(m_values.begin(), m_values.begin() + (std::ptrdiff_t)m_size, sorted.begin());
+
+    const std::size_t index = std::min(m_size - 1, (std::size_t)(p * (float)(m_size - 1) + 0.5f));
+    std::nth_element(sorted.begin(), sorted.begin() + (std::ptrdiff_t)index, sorted.begin() + (std::ptrdiff_t)m_size);
+    return sorted[index];
+}
+
+template <Dimension Dim> float perf_overlay<Dim>::ring::average() const
+{
+    if (m_size == 0)
+        return 0.f;
+    float sum = 0.f;
+    for (std::size_t i = 0; i < m_size; i++)
+        sum += m_values[i];
+    return sum / (float)m_size;
+}
+
+template <Dimension Dim> float perf_overlay<Dim>::ring::last() const
+{
+    return m_size == 0 ? 0.f : m_values[(m_head + SAMPLES - 1) % SAMPLES];
+}
+
+template <Dimension Dim> const float *perf_overlay<Dim>::ring::data() const
+{
+    return m_values.data();
+}
+template <Dimension Dim> std::size_t perf_overlay<Dim>::ring::size() const
+{
+    return m_size;
+}
+template <Dimension Dim> std::size_t perf_overlay<Dim>::ring::offset() const
+{
+    return m_size < SAMPLES ? 0 : m_head;
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::on_render(const float ts)
+{
+    LYNX_TRACE_SCOPE("lynx::perf_overlay::on_render")
+    app<Dim> *parent = this->parent();
+    window<Dim> &win = *parent->window();
+
+    m_frame.push(parent->frame_time().template as<kit::perf::time::milliseconds, float>());
+    m_update.push(parent->update_time().template as<kit::perf::time::milliseconds, float>());
+    m_render.push(parent->render_time().template as<kit::perf::time::milliseconds, float>());
+    // The profiler is read back by the rendering thread, so its frame time is taken from the published stats
+    if (const float gpu_milliseconds = win.render_stats().gpu_milliseconds; gpu_milliseconds > 0.f)
+        m_gpu.push(gpu_milliseconds);
+
+    // ImGui is not initialized for headless windows
+    if (win.headless())
+        return;
+
+    if (ImGui::Begin(this->id().c_str()))
+    {
+        draw_timings();
+        draw_render_stats();
+        draw_controls();
+    }
+    ImGui::End();
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::draw_timings() const
+{
+    if (!ImGui::CollapsingHeader("Timings", ImGuiTreeNodeFlags_DefaultOpen))
+        return;
+
+    const std::array<std::pair<const char *, const ring *>, 4> rings = {
+        {{"Frame", &m_frame}, {"Update", &m_update}, {"Render", &m_render}, {"GPU", &m_gpu}}};
+    if (ImGui::BeginTable("##percentiles", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        for (const char *header : {"ms", "avg", "p50", "p90", "p99", "max"})
+            ImGui::TableSetupColumn(header);
+        ImGui::TableHeadersRow();
+        for (const auto &[name, rng] : rings)
+        {
+            if (rng->size() == 0)
+                continue;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name);
+            for (const float value : {rng->average(), rng->percentile(0.5f), rng->percentile(0.9f),
+                                      rng->percentile(0.99f), rng->percentile(1.f)})
+            {
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", value);
+            }
+        }
+        ImGui::EndTable();
+    }
+    draw_layer_timings();
+
+#ifdef LYNX_ENABLE_IMPLOT
+    if (ImPlot::BeginPlot("##timeline", ImVec2(-1, 160)))
+    {
+        ImPlot::SetupAxes(nullptr, "ms", ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_AutoFit);
+        ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, (double)SAMPLES, ImGuiCond_Always);
+        for (const auto &[name, rng] : rings)
+            if (rng->size() > 0)
+                ImPlot::PlotLine(name, rng->data(), (int)rng->size(), 1.0, 0.0, 0, (int)rng->offset());
+        ImPlot::EndPlot();
+    }
+    if (ImPlot::BeginPlot("##histogram", ImVec2(-1, 160)))
+    {
+        ImPlot::SetupAxes("ms", nullptr, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        for (const auto &[name, rng] : rings)
+            if (rng->size() > 0)
+                ImPlot::PlotHistogram(name, rng->data(), (int)rng->size());
+        ImPlot::EndPlot();
+    }
+#else
+    for (const auto &[name, rng] : rings)
+        if (rng->size() > 0)
+            ImGui::PlotLines(name, rng->data(), (int)rng->size(), (int)rng->offset(), nullptr, 0.f, FLT_MAX,
+                             ImVec2(0, 50));
+#endif
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::draw_layer_timings() const
+{
+    const app<Dim> *parent = this->parent();
+    if (!parent->layer_timing_enabled() ||
+        !ImGui::BeginTable("##layers", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        return;
+
+    for (const char *header : {"Layer (avg/max ms)", "Update", "Render", "Events", "Submission"})
+        ImGui::TableSetupColumn(header);
+    ImGui::TableHeadersRow();
+    for (const auto &ly : *parent)
+    {
+        const layer_timings &timings = ly->timings();
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(ly->id().c_str());
+        for (const layer_timings::phase *phase :
+             {&timings.update, &timings.render, &timings.event, &timings.submission})
+        {
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f / %.2f", phase->average(), phase->max());
+        }
+    }
+    ImGui::EndTable();
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::draw_render_stats() const
+{
+    if (!ImGui::CollapsingHeader("Render stats"))
+        return;
+    const window<Dim> &win = *this->parent()->window();
+    const render_stats &stats = win.render_stats();
+
+    ImGui::Text("Draw calls: %u (%llu instances)", stats.draw_calls, (unsigned long long)stats.instances);
+    ImGui::Text("Vertices: %llu, indices: %llu", (unsigned long long)stats.vertices,
+                (unsigned long long)stats.indices);
+    ImGui::Text("Dispatches: %u", stats.dispatches);
+    ImGui::Text("Binds: %u pipelines, %u vertex buffers, %u index buffers", stats.pipeline_binds,
+                stats.vertex_buffer_binds, stats.index_buffer_binds);
+    ImGui::Text("Push constants: %llu bytes", (unsigned long long)stats.push_constant_bytes);
+    ImGui::Text("Allocations this frame: %u (%llu bytes), frees: %u", stats.allocations,
+                (unsigned long long)stats.allocated_bytes, stats.frees);
+
+    const device &dev = *win.device();
+    ImGui::Text("Device memory: %.2f MiB in %zu allocations", (double)dev.allocated_memory() / (1024.0 * 1024.0),
+                dev.allocation_count());
+    for (const render_stats::system_entry &entry : stats.render_systems)
+        ImGui::BulletText("%s: %zu", entry.name, entry.render_data);
+
+    const job_system &jobs = this->parent()->jobs();
+    ImGui::Text("Jobs: %llu executed, %llu stolen across %u workers", (unsigned long long)jobs.executed_jobs(),
+                (unsigned long long)jobs.stolen_jobs(), jobs.worker_count());
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::draw_controls()
+{
+    if (!ImGui::CollapsingHeader("Controls"))
+        return;
+    app<Dim> *parent = this->parent();
+    window<Dim> &win = *parent->window();
+
+    int cap = (int)parent->framerate_cap();
+    if (ImGui::SliderInt("Framerate cap", &cap, 0, 480, cap == 0 ? "Uncapped" : "%d"))
+        parent->limit_framerate((std::uint32_t)cap);
+    if (cap > 0)
+        ImGui::Text("Missed deadlines: %llu (last lateness: %.3f ms)",
+                    (unsigned long long)parent->pacer().missed_deadlines(),
+                    std::chrono::duration<float, std::milli>(parent->pacer().last_lateness()).count());
+
+    // The renderer belongs to the render thread while rendering is threaded, so it cannot be touched from here
+    if (win.threaded_rendering())
+        ImGui::TextDisabled("Renderer controls are unavailable while rendering is threaded");
+    else
+        draw_renderer_controls();
+
+    bool idle = parent->idle_mode();
+    if (ImGui::Checkbox("Idle mode", &idle))
+        parent->idle_mode(idle);
+    bool fast_forward = parent->fast_forward();
+    if (ImGui::Checkbox("Fast forward", &fast_forward))
+        parent->fast_forward(fast_forward);
+
+    bool parallel_updates = parent->parallel_updates();
+    if (ImGui::Checkbox("Parallel layer updates", &parallel_updates))
+        parent->parallel_updates(parallel_updates);
+
+    bool layer_timing = parent->layer_timing_enabled();
+    if (ImGui::Checkbox("Layer timing", &layer_timing))
+        parent->enable_layer_timing(layer_timing);
+
+    if (!trace::recording())
+    {
+        if (ImGui::Button("Start trace"))
+            trace::start();
+    }
+    else if (ImGui::Button("Stop trace"))
+        trace::stop();
+    ImGui::SameLine();
+    if (ImGui::Button("Dump last 300 frames"))
+        trace::dump("lynx-trace.json", 300);
+}
+
+template <Dimension Dim> void perf_overlay<Dim>::draw_renderer_controls()
+{
+    window<Dim> &win = *this->parent()->window();
+
+    // Both controls rebuild the swap chain, which is fine here because the frame has not begun yet: with threaded
+    // rendering off, rendering happens after every layer's on_render
+    lynx::swap_chain::config_info config = win.renderer().swap_chain().config();
+    int frames_in_flight = (int)config.frames_in_flight;
+    if (ImGui::SliderInt("Frames in flight", &frames_in_flight, 1, (int)swap_chain::MAX_FRAMES_IN_FLIGHT))
+    {
+        config.frames_in_flight = (std::uint32_t)frames_in_flight;
+        win.renderer().reconfigure(config);
+    }
+    static constexpr std::array<std::pair<VkPresentModeKHR, const char *>, 5> PRESENT_MODES = {
+        {{VK_PRESENT_MODE_MAX_ENUM_KHR, "Automatic"},
+         {VK_PRESENT_MODE_FIFO_KHR, "FIFO"},
+         {VK_PRESENT_MODE_FIFO_RELAXED_KHR, "FIFO relaxed"},
+         {VK_PRESENT_MODE_MAILBOX_KHR, "Mailbox"},
+         {VK_PRESENT_MODE_IMMEDIATE_KHR, "Immediate"}}};
+    const auto current = std::find_if(PRESENT_MODES.begin(), PRESENT_MODES.end(),
+                                      [&config](const auto &mode) { return mode.first == config.present_mode; });
+    if (ImGui::BeginCombo("Present mode", current != PRESENT_MODES.end() ? current->second : "Unknown"))
+    {
+        for (const auto &[mode, name] : PRESENT_MODES)
+            if (ImGui::Selectable(name, mode == config.present_mode) && mode != config.present_mode)
+            {
+                config.present_mode = mode;
+                win.renderer().reconfigure(config);
+            }
+        ImGui::EndCombo();
+    }
+
+    // Dynamic resolution is fed from the profiler, so profiling stays on while it is enabled
+    bool gpu_profiling = win.renderer().gpu_profiler() != nullptr;
+    ImGui::BeginDisabled(win.renderer().dynamic_resolution() != nullptr);
+    if (ImGui::Checkbox("GPU profiling", &gpu_profiling))
+    {
+        if (gpu_profiling)
+            win.renderer().enable_gpu_profiling();
+        else
+            win.renderer().disable_gpu_profiling();
+    }
+    ImGui::EndDisabled();
+
+    bool dynamic = win.renderer().dynamic_resolution() != nullptr;
+    if (ImGui::Checkbox("Dynamic resolution", &dynamic))
+    {
+        if (dynamic)
+            win.renderer().enable_dynamic_resolution();
+        else
+            win.renderer().disable_dynamic_resolution();
+    }
+    if (lynx::dynamic_resolution *drs = win.renderer().dynamic_resolution())
+    {
+        float budget = drs->target_milliseconds();
+        if (ImGui::SliderFloat("GPU budget (ms)", &budget, 1.f, 50.f, "%.1f"))
+            drs->target_milliseconds(budget);
+        const VkExtent2D extent = drs->scaled_extent();
+        ImGui::Text("Scale: %.2f (%ux%u)", drs->scale(), extent.width, extent.height);
+    }
+}
+
+template class perf_overlay<dimension::two>;
+template class perf_overlay<dimension::three>;
+} // namespace lynx
+#endif
@@ -7,17 +7,49 @@
 
 namespace lynx
 {
+#ifdef DEBUG
+// Nested draws, such as a drawable drawing its parts, come from the same thread and are fine
+class concurrent_draw_check
+{
+  public:
+    concurrent_draw_check(std::atomic<std::thread::id> &drawing_thread) : m_drawing_thread(drawing_thread)
+    {
+        const std::thread::id self = std::this_thread::get_id();
+        std::thread::id current{};
+        m_outermost = m_drawing_thread.compare_exchange_strong(current, self, std::memory_order_acquire);
+        KIT_ASSERT_ERROR(m_outermost || current == self,
+                         "Layers drawing from parallel updates must declare that they write layer::DRAWING")
+    }
+    ~concurrent_draw_check()
+    {
+        if (m_outermost)
+            m_drawing_thread.store(std::thread::id{}, std::memory_order_release);
+    }
+
+  private:
+    std::atomic<std::thread::id> &m_drawing_thread;
+    bool m_outermost;
+};
+#endif
+
 template <Dimension Dim>
-window<Dim>::window(const specs &spc) : nameable(spc.name), m_width(spc.width), m_height(spc.height)
+window<Dim>::window(const specs &spc)
+    : nameable(spc.name), m_extent(pack_extent(spc.width, spc.height)), m_headless(spc.headless || spc.null_backend),
+      m_null_backend(spc.null_backend)
 {
-    init();
-    input_t::install_callbacks(this);
+    init({spc.present_mode, spc.image_count, spc.frames_in_flight});
+    if (!m_headless)
+        input_t::install_callbacks(this);
 
     add_render_system<point_render_system<Dim>>();
     add_render_system<line_render_system<Dim>>();
     add_render_system<line_strip_render_system<Dim>>();
     add_render_system<triangle_render_system<Dim>>();
     add_render_system<triangle_strip_render_system<Dim>>();
+    add_render_system<thick_line_render_system<Dim>>();
+    add_render_system<trail_render_system<Dim>>();
+    add_render_system<point_cloud_render_system<Dim>>();
+    add_render_system<particle_render_system<Dim>>();
 
     if constexpr (std::is_same_v<Dim, dimension::two>)
         set_camera<orthographic2D>(pixel_aspect(), 5.f);
@@ -30,34 +62,47 @@ template <Dimension Dim> window<Dim>::~window()
     close();
 }
 
-template <Dimension Dim> void window<Dim>::init()
+template <Dimension Dim> void window<Dim>::init(const swap_chain::config_info &config)
 {
+    if (m_headless)
+    {
+        context_t::set(this);
+        m_device = kit::make_ref<lynx::device>(nullptr, m_null_backend);
+        m_renderer = kit::make_scope<renderer_t>(m_device, *this, config);
+        return;
+    }
+
     KIT_CHECK_RETURN_VALUE(glfwInit(), GLFW_TRUE, CRITICAL, "GLFW failed to initialize")
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
-    m_window = glfwCreateWindow((int)m_width, (int)m_height, m_name, nullptr, nullptr);
+    const VkExtent2D ext = extent();
+    m_window = glfwCreateWindow((int)ext.width, (int)ext.height, m_name, nullptr, nullptr);
     glfwSetWindowUserPointer(m_window, this);
 
     context_t::set(this);
     m_device = kit::make_ref<lynx::device>(m_window);
-    m_renderer = kit::make_scope<renderer_t>(m_device, *this);
+    m_renderer = kit::make_scope<renderer_t>(m_device, *this, config);
 }
 
 template <Dimension Dim> void window<Dim>::close()
 {
     clear_render_data();
-    glfwDestroyWindow(m_window);
+    m_headless_closed = true;
+    if (m_window)
+        glfwDestroyWindow(m_window);
     m_window = nullptr;
 }
 
 template <Dimension Dim> void window<Dim>::wait_for_device() const
 {
-    vkDeviceWaitIdle(m_device->vulkan_device());
+    m_device->wait_idle();
 }
 
 template <Dimension Dim> bool window<Dim>::closed()
 {
+    if (m_headless)
+        return m_headless_closed;
     if (!m_window)
         return true;
     if (glfwWindowShouldClose(m_window))
@@ -68,10 +113,42 @@ template <Dimension Dim> bool window<Dim>::closed()
     return false;
 }
 
+template <Dimension Dim> void window<Dim>::dispatch(const VkCommandBuffer command_buffer) const
+{
+    const std::uint32_t frame_index = m_renderer->frame_index();
+    m_renderer->begin_gpu_scope(command_buffer, "dispatch");
+    for (const auto &sys : m_render_systems)
+        sys->dispatch(command_buffer, frame_index);
+    m_renderer->end_gpu_scope(command_buffer);
+}
+
 template <Dimension Dim> void window<Dim>::render(const VkCommandBuffer command_buffer) const
 {
+    const camera_t &cam = m_threaded_rendering ? m_camera_snapshots[m_handoff.render_slot()] : *m_camera;
     for (const auto &sys : m_render_systems)
-        sys->render(command_buffer, *m_camera);
+    {
+        m_renderer->begin_gpu_scope(command_buffer, sys->name());
+        sys->render(command_buffer, cam, m_renderer->swap_chain().extent());
+        m_renderer->end_gpu_scope(command_buffer);
+    }
+}
+
+template <Dimension Dim> void window<Dim>::collect_stats()
+{
+    lynx::render_stats &stats = m_device->stats();
+    for (const auto &sys : m_render_systems)
+        stats.render_systems.push_back({sys->name(), sys->render_data_count()});
+    m_device->collect_allocation_stats(stats);
+    if (const gpu_profiler *profiler = m_renderer->gpu_profiler())
+        stats.gpu_milliseconds = profiler->frame_milliseconds();
+
+    {
+        const std::scoped_lock lock(m_stats_mutex);
+        m_render_stats = stats;
+        if (m_stats_history)
+            m_stats_history->push(stats);
+    }
+    stats.reset();
 }
 
 template <Dimension Dim> void window<Dim>::clear_render_data()
@@ -107,8 +184,7 @@ template <Dimension Dim> void window<Dim>::maintain_camera_aspect_ratio(const bo
 
 template <Dimension Dim> void window<Dim>::resize(const std::uint32_t width, const std::uint32_t height)
 {
-    m_width = width;
-    m_height = height;
+    m_extent.store(pack_extent(width, height), std::memory_order_relaxed);
     m_resized = true;
 }
 
@@ -130,31 +206,167 @@ template <Dimension Dim> event<Dim> window<Dim>::poll_event()
     return ev;
 }
 
+template <Dimension Dim> render_stats window<Dim>::render_stats() const
+{
+    const std::scoped_lock lock(m_stats_mutex);
+    return m_render_stats;
+}
+template <Dimension Dim> void window<Dim>::record_stats_history(const std::size_t capacity)
+{
+    const std::scoped_lock lock(m_stats_mutex);
+    m_stats_history = kit::make_scope<render_stats_history>(capacity);
+}
+template <Dimension Dim> void window<Dim>::stop_stats_history()
+{
+    const std::scoped_lock lock(m_stats_mutex);
+    m_stats_history.reset();
+}
+template <Dimension Dim> bool window<Dim>::recording_stats_history() const
+{
+    const std::scoped_lock lock(m_stats_mutex);
+    return (bool)m_stats_history;
+}
+template <Dimension Dim> render_stats_history window<Dim>::stats_history() const
+{
+    const std::scoped_lock lock(m_stats_mutex);
+    KIT_ASSERT_ERROR(m_stats_history, "Render stats history is not being recorded")
+    return *m_stats_history;
+}
+
 template <Dimension Dim> const renderer<Dim> &window<Dim>::renderer() const
 {
     return *m_renderer;
 }
+template <Dimension Dim> renderer<Dim> &window<Dim>::renderer()
+{
+    return *m_renderer;
+}
 
 template <Dimension Dim> const kit::ref<const lynx::device> &window<Dim>::device() const
 {
     return m_device;
 }
+
+template <Dimension Dim> job_system *window<Dim>::jobs() const
+{
+    return m_jobs;
+}
+template <Dimension Dim> void window<Dim>::jobs(job_system *jobs)
+{
+    m_jobs = jobs;
+}
 template <Dimension Dim>
 void window<Dim>::draw(const std::vector<vertex_t> &vertices, const topology tplg, const transform_t &transform)
 {
+    if (m_drawing_suspended)
+        return;
+#ifdef DEBUG
+    const concurrent_draw_check check(m_drawing_thread);
+#endif
     render_system_from_topology<render_system_t>(tplg)->draw(vertices, transform);
 }
 template <Dimension Dim>
 void window<Dim>::draw(const std::vector<vertex_t> &vertices, const std::vector<std::uint32_t> &indices,
                        const topology tplg, const transform_t &transform)
 {
+    if (m_drawing_suspended)
+        return;
+#ifdef DEBUG
+    const concurrent_draw_check check(m_drawing_thread);
+#endif
     render_system_from_topology<render_system_t>(tplg)->draw(vertices, indices, transform);
 }
 template <Dimension Dim> void window<Dim>::draw(const drawable_t &drawable)
 {
+    if (m_drawing_suspended)
+        return;
+#ifdef DEBUG
+    const concurrent_draw_check check(m_drawing_thread);
+#endif
     drawable.draw(*this);
 }
 
+template <Dimension Dim> void window<Dim>::suspend_drawing(const bool suspend)
+{
+    m_drawing_suspended = suspend;
+}
+template <Dimension Dim> bool window<Dim>::drawing_suspended() const
+{
+    return m_drawing_suspended;
+}
+template <Dimension Dim> void window<Dim>::discard_frame()
+{
+    clear_render_data();
+}
+
+template <Dimension Dim> void window<Dim>::threaded_rendering(const bool enabled)
+{
+    if (m_threaded_rendering == enabled)
+        return;
+    m_threaded_rendering = enabled;
+    m_handoff.reset();
+    m_swap_chain_aspect.store(pixel_aspect(), std::memory_order_relaxed);
+
+    // Slots other than the first may hold frames that were published but never rendered
+    for (std::uint32_t slot = 0; slot < frame_handoff::SLOTS; slot++)
+    {
+        use_slots(slot, slot);
+        clear_render_data();
+    }
+    if (enabled)
+        use_slots(m_handoff.record_slot(), m_handoff.render_slot());
+    else
+        use_slots(0, 0);
+}
+template <Dimension Dim> bool window<Dim>::threaded_rendering() const
+{
+    return m_threaded_rendering;
+}
+
+template <Dimension Dim> void window<Dim>::publish_frame()
+{
+    LYNX_TRACE_SCOPE("lynx::window::publish_frame")
+    KIT_ASSERT_ERROR(m_threaded_rendering, "Frames can only be published when rendering is threaded")
+    if (m_maintain_camera_aspect_ratio)
+        m_camera->keep_aspect_ratio(m_swap_chain_aspect.load(std::memory_order_relaxed));
+    m_camera->update_transformation_matrices();
+    m_camera_snapshots[m_handoff.record_slot()].capture(*m_camera);
+
+    const std::uint32_t record_slot = m_handoff.publish();
+    for (const auto &sys : m_render_systems)
+        sys->m_record_slot = record_slot;
+    clear_render_data();
+}
+
+template <Dimension Dim> bool window<Dim>::acquire_frame()
+{
+    LYNX_TRACE_SCOPE("lynx::window::acquire_frame")
+    if (!m_handoff.acquire())
+        return false;
+    const std::uint32_t render_slot = m_handoff.render_slot();
+    for (const auto &sys : m_render_systems)
+        sys->m_render_slot = render_slot;
+    return true;
+}
+
+template <Dimension Dim> const frame_handoff &window<Dim>::handoff() const
+{
+    return m_handoff;
+}
+template <Dimension Dim> frame_handoff &window<Dim>::handoff()
+{
+    return m_handoff;
+}
+
+template <Dimension Dim> void window<Dim>::use_slots(const std::uint32_t record_slot, const std::uint32_t render_slot)
+{
+    for (const auto &sys : m_render_systems)
+    {
+        sys->m_record_slot = record_slot;
+        sys->m_render_slot = render_slot;
+    }
+}
+
 template <Dimension Dim> GLFWwindow *window<Dim>::glfw_window() const
 {
     return m_window;
@@ -162,11 +374,11 @@ template <Dimension Dim> GLFWwindow *window<Dim>::glfw_window() const
 
 template <Dimension Dim> std::uint32_t window<Dim>::screen_width() const
 {
-    return m_width;
+    return extent().width;
 }
 template <Dimension Dim> std::uint32_t window<Dim>::screen_height() const
 {
-    return m_height;
+    return extent().height;
 }
 
 template <Dimension Dim> std::uint32_t window<Dim>::pixel_width() const
@@ -180,7 +392,8 @@ template <Dimension Dim> std::uint32_t window<Dim>::pixel_height() const
 
 template <Dimension Dim> float window<Dim>::screen_aspect() const
 {
-    return (float)m_width / (float)m_height;
+    const VkExtent2D ext = extent();
+    return (float)ext.width / (float)ext.height;
 }
 template <Dimension Dim> float window<Dim>::pixel_aspect() const
 {
@@ -189,14 +402,31 @@ template <Dimension Dim> float window<Dim>::pixel_aspect() const
 
 template <Dimension Dim> VkExtent2D window<Dim>::extent() const
 {
-    return {m_width, m_height};
+    const std::uint64_t ext = m_extent.load(std::memory_order_relaxed);
+    return {(std::uint32_t)(ext >> 32), (std::uint32_t)ext};
+}
+
+template <Dimension Dim> std::uint64_t window<Dim>::pack_extent(const std::uint32_t width, const std::uint32_t height)
+{
+    return ((std::uint64_t)width << 32) | height;
 }
 
 template <Dimension Dim> bool window<Dim>::should_close() const
 {
+    if (m_headless)
+        return m_headless_closed;
     return !m_window || glfwWindowShouldClose(m_window);
 }
 
+template <Dimension Dim> bool window<Dim>::headless() const
+{
+    return m_headless;
+}
+template <Dimension Dim> bool window<Dim>::null_backend() const
+{
+    return m_null_backend;
+}
+
 template class window<dimension::two>;
 template class window<dimension::three>;
 
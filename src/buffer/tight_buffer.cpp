@@ -56,9 +56,7 @@ template <typename T> T *tight_buffer<T>::map(std::size_t index_offset, std::siz
         unmap();
 
     const VkDeviceSize size = map_size == SIZE_MAX ? VK_WHOLE_SIZE : (map_size * sizeof(T));
-    KIT_CHECK_RETURN_VALUE(
-        vkMapMemory(m_device->vulkan_device(), m_memory, index_offset, size, flags, (void **)&m_mapped_data),
-        VK_SUCCESS, CRITICAL, "Failed to map memory");
+    m_mapped_data = (T *)m_device->map_memory(m_memory, index_offset, size, flags);
     return m_mapped_data;
 }
 
@@ -66,7 +64,7 @@ template <typename T> bool tight_buffer<T>::unmap()
 {
     if (!m_mapped_data)
         return false;
-    vkUnmapMemory(m_device->vulkan_device(), m_memory);
+    m_device->unmap_memory(m_memory);
     m_mapped_data = nullptr;
 
     return true;
@@ -87,15 +85,7 @@ template <typename T> T *tight_buffer<T>::data()
 template <typename T> void tight_buffer<T>::flush(std::size_t index_offset, std::size_t flush_size)
 {
     const VkDeviceSize size = flush_size == SIZE_MAX ? VK_WHOLE_SIZE : (flush_size * sizeof(T));
-
-    VkMappedMemoryRange mapped_range{};
-    mapped_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    mapped_range.memory = m_memory;
-    mapped_range.offset = index_offset;
-    mapped_range.size = size;
-
-    KIT_CHECK_RETURN_VALUE(vkFlushMappedMemoryRanges(m_device->vulkan_device(), 1, &mapped_range), VK_SUCCESS, CRITICAL,
-                           "Failed to flush memory. size: {0}, offset: {1}", flush_size, index_offset)
+    m_device->flush_memory(m_memory, size, index_offset);
 }
 
 template <typename T> void tight_buffer<T>::transfer(const tight_buffer &src_buffer)
@@ -126,13 +116,14 @@ template <typename T> bool tight_buffer<T>::mapped() const
 
 template <typename T> void tight_buffer<T>::cleanup()
 {
-    vkDeviceWaitIdle(m_device->vulkan_device());
+    m_device->wait_idle();
     unmap();
-    vkDestroyBuffer(m_device->vulkan_device(), m_buffer, nullptr);
-    vkFreeMemory(m_device->vulkan_device(), m_memory, nullptr);
+    m_device->destroy_buffer(m_buffer, m_memory);
 }
 
 template class tight_buffer<vertex2D>;
 template class tight_buffer<vertex3D>;
 template class tight_buffer<std::uint32_t>;
+template class tight_buffer<point_vertex2D>;
+template class tight_buffer<point_vertex3D>;
 } // namespace lynx
\ No newline at end of file
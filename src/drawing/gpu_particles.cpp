@@ -0,0 +1,119 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/drawing/gpu_particles.hpp"
+#include "lynx/app/window.hpp"
+
+namespace lynx
+{
+template <Dimension Dim> gpu_particles<Dim>::gpu_particles(const std::size_t capacity)
+{
+    KIT_ASSERT_ERROR(capacity > 0, "Particle capacity must be greater than 0")
+    m_particles = kit::make_ref<buffer>(context_t::device(), sizeof(gpu_particle), capacity,
+                                        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                                            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+}
+
+template <Dimension Dim>
+gpu_particles<Dim>::gpu_particles(const std::span<const gpu_particle> particles) : gpu_particles(particles.size())
+{
+    reset(particles);
+}
+
+template <Dimension Dim> void gpu_particles<Dim>::draw(window_t &win) const
+{
+    if (m_size == 0)
+        return;
+    auto rs = win.template get_render_system<particle_render_system<Dim>>();
+    KIT_ASSERT_ERROR(rs, "The window must have a particle render system to draw gpu particles")
+
+    glm::vec4 gravity{0.f};
+    for (std::size_t i = 0; i < Dim::N; i++)
+        gravity[i] = m_gravity[i];
+
+    rs->push_particle_data(m_particles, transform.center_scale_rotate_translate4(), (std::uint32_t)m_size,
+                           m_pending_dt, gravity, m_damping, m_round);
+}
+
+template <Dimension Dim> void gpu_particles<Dim>::reset(const std::span<const gpu_particle> particles)
+{
+    KIT_ASSERT_ERROR(particles.size() <= capacity(), "Particle count exceeds capacity! Count: {0}, capacity: {1}",
+                     particles.size(), capacity())
+    m_size = particles.size();
+    if (m_size == 0)
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::gpu_particles::reset")
+    const kit::ref<const device> &dev = context_t::device();
+    buffer staging{dev,
+                   sizeof(gpu_particle),
+                   m_size,
+                   VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                   VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT};
+    staging.map();
+    staging.write(particles.data(), particles.size_bytes());
+
+    // The particle buffer may still be in use by frames in flight
+    dev->wait_idle();
+    dev->copy_buffer(m_particles->vulkan_buffer(), staging.vulkan_buffer(), particles.size_bytes());
+}
+
+template <Dimension Dim> void gpu_particles<Dim>::step(const float dt)
+{
+    m_pending_dt->fetch_add(dt, std::memory_order_relaxed);
+}
+
+template <Dimension Dim> std::size_t gpu_particles<Dim>::size() const
+{
+    return m_size;
+}
+template <Dimension Dim> std::size_t gpu_particles<Dim>::capacity() const
+{
+    return m_particles->instance_count();
+}
+
+template <Dimension Dim> const typename gpu_particles<Dim>::vec_t &gpu_particles<Dim>::gravity() const
+{
+    return m_gravity;
+}
+template <Dimension Dim> void gpu_particles<Dim>::gravity(const vec_t &gravity)
+{
+    m_gravity = gravity;
+}
+
+template <Dimension Dim> float gpu_particles<Dim>::damping() const
+{
+    return m_damping;
+}
+template <Dimension Dim> void gpu_particles<Dim>::damping(const float damping)
+{
+    m_damping = damping;
+}
+
+template <Dimension Dim> bool gpu_particles<Dim>::round() const
+{
+    return m_round;
+}
+template <Dimension Dim> void gpu_particles<Dim>::round(const bool round)
+{
+    m_round = round;
+}
+
+template <Dimension Dim>
+gpu_particle gpu_particles<Dim>::particle(const vec_t &position, const vec_t &velocity, const float lifetime,
+                                          const float size, const lynx::color &color)
+{
+    gpu_particle p{};
+    for (std::size_t i = 0; i < Dim::N; i++)
+    {
+        p.position[i] = position[i];
+        p.velocity[i] = velocity[i];
+    }
+    p.position.w = lifetime;
+    p.velocity.w = size;
+    p.color = color;
+    return p;
+}
+
+template class gpu_particles<dimension::two>;
+template class gpu_particles<dimension::three>;
+} // namespace lynx
@@ -162,9 +162,268 @@ template <Dimension Dim> void line_strip<Dim>::color(const lynx::color &color)
         vdata[i].color = color;
 }
 
+template <Dimension Dim>
+thick_line<Dim>::thick_line(const vec_t &p1, const vec_t &p2, const float width, const lynx::color &color)
+    : m_p1(p1), m_p2(p2), m_width(width), m_color(color)
+{
+}
+template <Dimension Dim>
+thick_line<Dim>::thick_line(const float width, const lynx::color &color)
+    : thick_line(vec_t(-1.f), vec_t(1.f), width, color)
+{
+}
+
+template <Dimension Dim> void thick_line<Dim>::draw(window_t &win) const
+{
+    auto rs = win.template get_render_system<thick_line_render_system<Dim>>();
+    KIT_ASSERT_ERROR(rs, "The window must have a thick line render system to draw thick lines")
+    rs->push_segment(m_p1, m_p2, m_width, m_color, m_rounded_caps ? line_join::ROUND : line_join::NONE);
+}
+
+template <Dimension Dim> const glm::vec<Dim::N, float> &thick_line<Dim>::p1() const
+{
+    return m_p1;
+}
+template <Dimension Dim> const glm::vec<Dim::N, float> &thick_line<Dim>::p2() const
+{
+    return m_p2;
+}
+template <Dimension Dim> void thick_line<Dim>::p1(const vec_t &p1)
+{
+    m_p1 = p1;
+}
+template <Dimension Dim> void thick_line<Dim>::p2(const vec_t &p2)
+{
+    m_p2 = p2;
+}
+
+template <Dimension Dim> const color &thick_line<Dim>::color() const
+{
+    return m_color;
+}
+template <Dimension Dim> void thick_line<Dim>::color(const lynx::color &color)
+{
+    m_color = color;
+}
+
+template <Dimension Dim> float thick_line<Dim>::width() const
+{
+    return m_width;
+}
+template <Dimension Dim> void thick_line<Dim>::width(const float width)
+{
+    m_width = width;
+}
+
+template <Dimension Dim> bool thick_line<Dim>::rounded_caps() const
+{
+    return m_rounded_caps;
+}
+template <Dimension Dim> void thick_line<Dim>::rounded_caps(const bool rounded)
+{
+    m_rounded_caps = rounded;
+}
+
+template <Dimension Dim>
+thick_line_strip<Dim>::thick_line_strip(const std::vector<vec_t> &points, const float width,
+                                        const lynx::color &color, const line_join join)
+    : m_points(points), m_width(width), m_color(color), m_join(join)
+{
+}
+template <Dimension Dim>
+thick_line_strip<Dim>::thick_line_strip(const float width, const lynx::color &color, const line_join join)
+    : thick_line_strip({vec_t(-1.f), vec_t(1.f)}, width, color, join)
+{
+}
+
+template <Dimension Dim> void thick_line_strip<Dim>::draw(window_t &win) const
+{
+    auto rs = win.template get_render_system<thick_line_render_system<Dim>>();
+    KIT_ASSERT_ERROR(rs, "The window must have a thick line render system to draw thick lines")
+
+    const glm::mat4 mat = transform.center_scale_rotate_translate4();
+    m_transformed_points.resize(m_points.size());
+    for (std::size_t i = 0; i < m_points.size(); i++)
+    {
+        if constexpr (std::is_same_v<Dim, dimension::two>)
+            m_transformed_points[i] = vec_t(mat * glm::vec4(m_points[i], 0.f, 1.f));
+        else
+            m_transformed_points[i] = vec_t(mat * glm::vec4(m_points[i], 1.f));
+    }
+    rs->push_strip(m_transformed_points.data(), m_transformed_points.size(), m_width, m_color, m_join);
+}
+
+template <Dimension Dim> const glm::vec<Dim::N, float> &thick_line_strip<Dim>::operator[](const std::size_t index) const
+{
+    KIT_ASSERT_ERROR(index < m_points.size(), "Index exceeds strip's point count! Index: {0}, points: {1}", index,
+                     m_points.size())
+    return m_points[index];
+}
+template <Dimension Dim> glm::vec<Dim::N, float> &thick_line_strip<Dim>::operator[](const std::size_t index)
+{
+    KIT_ASSERT_ERROR(index < m_points.size(), "Index exceeds strip's point count! Index: {0}, points: {1}", index,
+                     m_points.size())
+    return m_points[index];
+}
+
+template <Dimension Dim> const std::vector<glm::vec<Dim::N, float>> &thick_line_strip<Dim>::points() const
+{
+    return m_points;
+}
+template <Dimension Dim> std::vector<glm::vec<Dim::N, float>> &thick_line_strip<Dim>::points()
+{
+    return m_points;
+}
+template <Dimension Dim> std::size_t thick_line_strip<Dim>::size() const
+{
+    return m_points.size();
+}
+
+template <Dimension Dim> const color &thick_line_strip<Dim>::color() const
+{
+    return m_color;
+}
+template <Dimension Dim> void thick_line_strip<Dim>::color(const lynx::color &color)
+{
+    m_color = color;
+}
+
+template <Dimension Dim> float thick_line_strip<Dim>::width() const
+{
+    return m_width;
+}
+template <Dimension Dim> void thick_line_strip<Dim>::width(const float width)
+{
+    m_width = width;
+}
+
+template <Dimension Dim> line_join thick_line_strip<Dim>::join() const
+{
+    return m_join;
+}
+template <Dimension Dim> void thick_line_strip<Dim>::join(const line_join join)
+{
+    m_join = join;
+}
+
+template <Dimension Dim>
+trail<Dim>::trail(const std::size_t capacity, const lynx::color &color, const bool fade)
+    : modelable<Dim>(context_t::device(), std::vector<vertex_t>(capacity + 1, vertex_t(vec_t(0.f), color))),
+      m_color(color), m_capacity(capacity), m_fade(fade)
+{
+    KIT_ASSERT_ERROR(capacity > 1, "A trail must have a capacity of at least 2 points. Capacity: {0}", capacity)
+}
+
+template <Dimension Dim> void trail<Dim>::draw(window_t &win) const
+{
+    auto rs = win.template get_render_system<trail_render_system<Dim>>();
+    KIT_ASSERT_ERROR(rs, "The window must have a trail render system to draw trails")
+    rs->push_trail_data(this->m_model, m_transform.center_scale_rotate_translate4(), (std::uint32_t)m_start,
+                        (std::uint32_t)m_count, m_fade);
+}
+
+template <Dimension Dim> void trail<Dim>::write(const std::size_t index, const vertex_t &vtx)
+{
+    this->m_model->vertex(index, vtx);
+    if (index == 0)
+        this->m_model->vertex(m_capacity, vtx);
+}
+
+template <Dimension Dim> void trail<Dim>::append(const vec_t &point)
+{
+    append(point, m_color);
+}
+template <Dimension Dim> void trail<Dim>::append(const vec_t &point, const lynx::color &color)
+{
+    if (m_count < m_capacity)
+    {
+        write((m_start + m_count) % m_capacity, {point, color});
+        m_count++;
+        return;
+    }
+    write(m_start, {point, color});
+    m_start = (m_start + 1) % m_capacity;
+}
+
+template <Dimension Dim> void trail<Dim>::clear()
+{
+    m_start = 0;
+    m_count = 0;
+}
+
+template <Dimension Dim> const vertex<Dim> &trail<Dim>::operator[](const std::size_t index) const
+{
+    KIT_ASSERT_ERROR(index < m_count, "Index exceeds trail's point count! Index: {0}, points: {1}", index, m_count)
+    return this->m_model->vertex((m_start + index) % m_capacity);
+}
+template <Dimension Dim> const vertex<Dim> &trail<Dim>::front() const
+{
+    return (*this)[0];
+}
+template <Dimension Dim> const vertex<Dim> &trail<Dim>::back() const
+{
+    return (*this)[m_count - 1];
+}
+
+template <Dimension Dim> std::size_t trail<Dim>::size() const
+{
+    return m_count;
+}
+template <Dimension Dim> std::size_t trail<Dim>::capacity() const
+{
+    return m_capacity;
+}
+template <Dimension Dim> bool trail<Dim>::empty() const
+{
+    return m_count == 0;
+}
+template <Dimension Dim> bool trail<Dim>::full() const
+{
+    return m_count == m_capacity;
+}
+
+template <Dimension Dim> const color &trail<Dim>::color() const
+{
+    return m_color;
+}
+template <Dimension Dim> void trail<Dim>::color(const lynx::color &color)
+{
+    m_color = color;
+    vertex_t *vdata = this->m_model->vertex_data();
+    for (std::size_t i = 0; i < this->m_model->vertex_count(); i++)
+        vdata[i].color = color;
+}
+
+template <Dimension Dim> bool trail<Dim>::fade() const
+{
+    return m_fade;
+}
+template <Dimension Dim> void trail<Dim>::fade(const bool fade)
+{
+    m_fade = fade;
+}
+
+template <Dimension Dim> const typename Dim::transform_t *trail<Dim>::parent() const
+{
+    return m_transform.parent;
+}
+template <Dimension Dim> void trail<Dim>::parent(const transform_t *parent)
+{
+    m_transform.parent = parent;
+}
+
 template class thin_line<dimension::two>;
 template class thin_line<dimension::three>;
 
 template class line_strip<dimension::two>;
 template class line_strip<dimension::three>;
+
+template class thick_line<dimension::two>;
+template class thick_line<dimension::three>;
+
+template class thick_line_strip<dimension::two>;
+template class thick_line_strip<dimension::three>;
+
+template class trail<dimension::two>;
+template class trail<dimension::three>;
 } // namespace lynx
\ No newline at end of file
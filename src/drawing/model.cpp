@@ -1,6 +1,7 @@
 #include "lynx/internal/pch.hpp"
 #include "lynx/drawing/model.hpp"
 #include "lynx/geometry/camera.hpp"
+#include "lynx/rendering/device.hpp"
 
 namespace lynx
 {
@@ -68,19 +69,16 @@ template <Dimension Dim> void model<Dim>::copy(const model &other)
 
 template <Dimension Dim> void model<Dim>::bind(VkCommandBuffer command_buffer) const
 {
-    const std::array<VkBuffer, 1> buffers = {m_vertex_buffer->vulkan_buffer()};
-    const std::array<VkDeviceSize, 1> offsets = {0};
-    vkCmdBindVertexBuffers(command_buffer, 0, 1, buffers.data(), offsets.data());
-
+    m_device->bind_vertex_buffer(command_buffer, m_vertex_buffer->vulkan_buffer());
     if (m_index_buffer)
-        vkCmdBindIndexBuffer(command_buffer, m_index_buffer->vulkan_buffer(), 0, VK_INDEX_TYPE_UINT32);
+        m_device->bind_index_buffer(command_buffer, m_index_buffer->vulkan_buffer());
 }
 template <Dimension Dim> void model<Dim>::draw(VkCommandBuffer command_buffer) const
 {
     if (has_index_buffers())
-        vkCmdDrawIndexed(command_buffer, (std::uint32_t)m_index_buffer->size(), 1, 0, 0, 0);
+        m_device->draw_indexed(command_buffer, (std::uint32_t)m_index_buffer->size());
     else
-        vkCmdDraw(command_buffer, (std::uint32_t)m_vertex_buffer->size(), 1, 0, 0);
+        m_device->draw(command_buffer, (std::uint32_t)m_vertex_buffer->size());
 }
 
 template <Dimension Dim> bool model<Dim>::has_index_buffers() const
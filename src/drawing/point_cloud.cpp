@@ -0,0 +1,172 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/drawing/point_cloud.hpp"
+#include "lynx/app/window.hpp"
+#include "lynx/rendering/render_system.hpp"
+
+namespace lynx
+{
+template <Dimension Dim>
+point_cloud<Dim>::point_cloud(const std::size_t capacity, const float size, const lynx::color &color)
+    : m_point_size(size), m_color(color)
+{
+    reserve(capacity);
+}
+
+template <Dimension Dim> point_cloud<Dim>::point_cloud(const point_cloud &other) : drawable<Dim>(other)
+{
+    *this = other;
+}
+template <Dimension Dim> point_cloud<Dim> &point_cloud<Dim>::operator=(const point_cloud &other)
+{
+    if (this == &other)
+        return *this;
+    transform = other.transform;
+    m_points = other.m_points ? kit::make_ref<point_buffer_t>(*other.m_points) : nullptr;
+    m_size = other.m_size;
+    m_point_size = other.m_point_size;
+    m_color = other.m_color;
+    m_round = other.m_round;
+    return *this;
+}
+
+template <Dimension Dim> void point_cloud<Dim>::draw(window_t &win) const
+{
+    if (m_size == 0)
+        return;
+    auto rs = win.template get_render_system<point_cloud_render_system<Dim>>();
+    KIT_ASSERT_ERROR(rs, "The window must have a point cloud render system to draw point clouds")
+    rs->push_cloud_data(m_points, transform.center_scale_rotate_translate4(), (std::uint32_t)m_size, m_round);
+}
+
+template <Dimension Dim> void point_cloud<Dim>::update(const std::span<const point_t> points, const std::size_t offset)
+{
+    if (offset + points.size() > m_size)
+        resize(offset + points.size());
+    std::memcpy(m_points->data() + offset, points.data(), points.size_bytes());
+}
+template <Dimension Dim> void point_cloud<Dim>::update(const std::span<const vec_t> positions, const std::size_t offset)
+{
+    if (offset + positions.size() > m_size)
+        resize(offset + positions.size());
+    point_t *pdata = m_points->data() + offset;
+    for (std::size_t i = 0; i < positions.size(); i++)
+        pdata[i].position = positions[i];
+}
+template <Dimension Dim>
+void point_cloud<Dim>::update_sizes(const std::span<const float> sizes, const std::size_t offset)
+{
+    KIT_ASSERT_ERROR(offset + sizes.size() <= m_size, "Size update exceeds point count! Points: {0}", m_size)
+    point_t *pdata = m_points->data() + offset;
+    for (std::size_t i = 0; i < sizes.size(); i++)
+        pdata[i].size = sizes[i];
+}
+template <Dimension Dim>
+void point_cloud<Dim>::update_colors(const std::span<const lynx::color> colors, const std::size_t offset)
+{
+    KIT_ASSERT_ERROR(offset + colors.size() <= m_size, "Color update exceeds point count! Points: {0}", m_size)
+    point_t *pdata = m_points->data() + offset;
+    for (std::size_t i = 0; i < colors.size(); i++)
+        pdata[i].color = point_t::pack(colors[i]);
+}
+
+template <Dimension Dim> void point_cloud<Dim>::resize(const std::size_t size)
+{
+    if (size > capacity())
+        reserve(std::max(size, 2 * capacity()));
+    if (size > m_size)
+        fill_defaults(m_size, size);
+    m_size = size;
+}
+
+template <Dimension Dim> void point_cloud<Dim>::reserve(const std::size_t capacity)
+{
+    if (m_points && capacity <= m_points->size())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::point_cloud::reserve")
+    auto points =
+        kit::make_ref<point_buffer_t>(context_t::device(), std::max(capacity, (std::size_t)1),
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                      VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    points->map();
+    if (m_points && m_size > 0)
+        std::memcpy(points->data(), m_points->data(), m_size * sizeof(point_t));
+    m_points = points;
+}
+
+template <Dimension Dim> void point_cloud<Dim>::fill_defaults(const std::size_t from, const std::size_t to)
+{
+    const point_t pt{vec_t(0.f), m_point_size, m_color};
+    std::fill(m_points->data() + from, m_points->data() + to, pt);
+}
+
+template <Dimension Dim> const point_vertex<Dim> *point_cloud<Dim>::data() const
+{
+    return m_points->data();
+}
+template <Dimension Dim> point_vertex<Dim> *point_cloud<Dim>::data()
+{
+    return m_points->data();
+}
+
+template <Dimension Dim> const point_vertex<Dim> &point_cloud<Dim>::operator[](const std::size_t index) const
+{
+    KIT_ASSERT_ERROR(index < m_size, "Index exceeds point count! Index: {0}, points: {1}", index, m_size)
+    return m_points->data()[index];
+}
+template <Dimension Dim> point_vertex<Dim> &point_cloud<Dim>::operator[](const std::size_t index)
+{
+    KIT_ASSERT_ERROR(index < m_size, "Index exceeds point count! Index: {0}, points: {1}", index, m_size)
+    return m_points->data()[index];
+}
+
+template <Dimension Dim> std::size_t point_cloud<Dim>::size() const
+{
+    return m_size;
+}
+template <Dimension Dim> std::size_t point_cloud<Dim>::capacity() const
+{
+    return m_points ? m_points->size() : 0;
+}
+template <Dimension Dim> bool point_cloud<Dim>::empty() const
+{
+    return m_size == 0;
+}
+
+template <Dimension Dim> float point_cloud<Dim>::point_size() const
+{
+    return m_point_size;
+}
+template <Dimension Dim> void point_cloud<Dim>::point_size(const float size)
+{
+    m_point_size = size;
+    point_t *pdata = m_points->data();
+    for (std::size_t i = 0; i < m_size; i++)
+        pdata[i].size = size;
+}
+
+template <Dimension Dim> const color &point_cloud<Dim>::color() const
+{
+    return m_color;
+}
+template <Dimension Dim> void point_cloud<Dim>::color(const lynx::color &color)
+{
+    m_color = color;
+    const std::uint32_t packed = point_t::pack(color);
+    point_t *pdata = m_points->data();
+    for (std::size_t i = 0; i < m_size; i++)
+        pdata[i].color = packed;
+}
+
+template <Dimension Dim> bool point_cloud<Dim>::round() const
+{
+    return m_round;
+}
+template <Dimension Dim> void point_cloud<Dim>::round(const bool round)
+{
+    m_round = round;
+}
+
+template class point_cloud<dimension::two>;
+template class point_cloud<dimension::three>;
+} // namespace lynx
@@ -0,0 +1,137 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/drawing/strip_batch.hpp"
+#include "lynx/app/window.hpp"
+
+namespace lynx
+{
+template <Dimension Dim>
+strip_batch<Dim>::strip_batch(const topology tplg, const std::size_t vertex_capacity)
+    : modelable<Dim>(context_t::device(), std::vector<vertex_t>(vertex_capacity),
+                     std::vector<std::uint32_t>(vertex_capacity + vertex_capacity / 2, RESTART_INDEX)),
+      m_topology(tplg)
+{
+    KIT_ASSERT_ERROR(tplg == topology::LINE_STRIP || tplg == topology::TRIANGLE_STRIP,
+                     "A strip batch topology must be either a line strip or a triangle strip")
+    KIT_ASSERT_ERROR(vertex_capacity > 1, "A strip batch must have a vertex capacity of at least 2")
+}
+
+template <Dimension Dim> void strip_batch<Dim>::draw(window_t &win) const
+{
+    if (m_strips.empty())
+        return;
+    drawable_t::default_draw(win, this->m_model, transform.center_scale_rotate_translate4(), m_topology);
+}
+
+template <Dimension Dim> std::size_t strip_batch<Dim>::add_strip(const std::vector<vertex_t> &vertices)
+{
+    KIT_ASSERT_ERROR(vertices.size() > 1, "A strip must have at least 2 vertices. Vertices: {0}", vertices.size())
+    reserve(m_vertex_count + vertices.size(), m_index_count + vertices.size() + 1);
+
+    vertex_t *vdata = this->m_model->vertex_data();
+    std::uint32_t *idata = this->m_model->index_data();
+    for (std::size_t i = 0; i < vertices.size(); i++)
+    {
+        vdata[m_vertex_count + i] = vertices[i];
+        idata[m_index_count + i] = (std::uint32_t)(m_vertex_count + i);
+    }
+    idata[m_index_count + vertices.size()] = RESTART_INDEX;
+
+    m_strips.push_back({m_vertex_count, vertices.size()});
+    m_vertex_count += vertices.size();
+    m_index_count += vertices.size() + 1;
+    return m_strips.size() - 1;
+}
+
+template <Dimension Dim>
+std::size_t strip_batch<Dim>::add_strip(const std::vector<vec_t> &points, const lynx::color &color)
+{
+    std::vector<vertex_t> vertices;
+    vertices.reserve(points.size());
+    for (const vec_t &p : points)
+        vertices.emplace_back(p, color);
+    return add_strip(vertices);
+}
+
+template <Dimension Dim> void strip_batch<Dim>::clear()
+{
+    std::uint32_t *idata = this->m_model->index_data();
+    std::fill(idata, idata + m_index_count, RESTART_INDEX);
+
+    m_strips.clear();
+    m_vertex_count = 0;
+    m_index_count = 0;
+}
+
+template <Dimension Dim>
+void strip_batch<Dim>::reserve(const std::size_t vertex_capacity, const std::size_t index_capacity)
+{
+    const std::size_t current_vcap = this->m_model->vertex_count();
+    const std::size_t current_icap = this->m_model->index_count();
+    if (vertex_capacity <= current_vcap && index_capacity <= current_icap)
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::strip_batch::reserve")
+    const std::size_t new_vcap = std::max(vertex_capacity, 2 * current_vcap);
+    const std::size_t new_icap = std::max(index_capacity, 2 * current_icap);
+
+    std::vector<vertex_t> vertices(new_vcap);
+    std::vector<std::uint32_t> indices(new_icap, RESTART_INDEX);
+
+    const vertex_t *vdata = this->m_model->vertex_data();
+    const std::uint32_t *idata = this->m_model->index_data();
+    std::copy(vdata, vdata + m_vertex_count, vertices.begin());
+    std::copy(idata, idata + m_index_count, indices.begin());
+
+    this->m_model = kit::make_ref<model_t>(context_t::device(), vertices, indices);
+}
+
+template <Dimension Dim>
+const vertex<Dim> &strip_batch<Dim>::vertex(const std::size_t strip_index, const std::size_t index) const
+{
+    const strip &s = (*this)[strip_index];
+    KIT_ASSERT_ERROR(index < s.size, "Index exceeds strip's vertex count! Index: {0}, vertices: {1}", index, s.size)
+    return this->m_model->vertex(s.offset + index);
+}
+template <Dimension Dim>
+void strip_batch<Dim>::vertex(const std::size_t strip_index, const std::size_t index, const vertex_t &vtx)
+{
+    const strip &s = (*this)[strip_index];
+    KIT_ASSERT_ERROR(index < s.size, "Index exceeds strip's vertex count! Index: {0}, vertices: {1}", index, s.size)
+    this->m_model->vertex(s.offset + index, vtx);
+}
+
+template <Dimension Dim>
+const typename strip_batch<Dim>::strip &strip_batch<Dim>::operator[](const std::size_t strip_index) const
+{
+    KIT_ASSERT_ERROR(strip_index < m_strips.size(), "Strip index exceeds strip count! Index: {0}, strips: {1}",
+                     strip_index, m_strips.size())
+    return m_strips[strip_index];
+}
+
+template <Dimension Dim> std::size_t strip_batch<Dim>::strip_count() const
+{
+    return m_strips.size();
+}
+template <Dimension Dim> std::size_t strip_batch<Dim>::vertex_count() const
+{
+    return m_vertex_count;
+}
+template <Dimension Dim> std::size_t strip_batch<Dim>::vertex_capacity() const
+{
+    return this->m_model->vertex_count();
+}
+template <Dimension Dim> bool strip_batch<Dim>::empty() const
+{
+    return m_strips.empty();
+}
+
+template <Dimension Dim> void strip_batch<Dim>::color(const lynx::color &color)
+{
+    vertex_t *vdata = this->m_model->vertex_data();
+    for (std::size_t i = 0; i < m_vertex_count; i++)
+        vdata[i].color = color;
+}
+
+template class strip_batch<dimension::two>;
+template class strip_batch<dimension::three>;
+} // namespace lynx
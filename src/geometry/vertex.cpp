@@ -21,6 +21,39 @@ template <Dimension Dim> std::vector<VkVertexInputAttributeDescription> vertex<D
                 {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(vertex3D, color)}};
 }
 
+template <Dimension Dim>
+point_vertex<Dim>::point_vertex(const vec_t &position, const float size, const lynx::color &pcolor)
+    : position(position), size(size), color(pack(pcolor))
+{
+}
+
+template <Dimension Dim> std::uint32_t point_vertex<Dim>::pack(const lynx::color &color)
+{
+    return (std::uint32_t)color.r() | ((std::uint32_t)color.g() << 8) | ((std::uint32_t)color.b() << 16) |
+           ((std::uint32_t)color.a() << 24);
+}
+
+template <Dimension Dim>
+std::vector<VkVertexInputBindingDescription> point_vertex<Dim>::binding_descriptions(
+    const VkVertexInputRate input_rate)
+{
+    return {{0, sizeof(point_vertex), input_rate}};
+}
+template <Dimension Dim> std::vector<VkVertexInputAttributeDescription> point_vertex<Dim>::attribute_descriptions()
+{
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        return {{0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(point_vertex, position)},
+                {1, 0, VK_FORMAT_R32_SFLOAT, offsetof(point_vertex, size)},
+                {2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(point_vertex, color)}};
+    else
+        return {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(point_vertex3D, position)},
+                {1, 0, VK_FORMAT_R32_SFLOAT, offsetof(point_vertex3D, size)},
+                {2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(point_vertex3D, color)}};
+}
+
 template struct vertex<dimension::two>;
 template struct vertex<dimension::three>;
+
+template struct point_vertex<dimension::two>;
+template struct point_vertex<dimension::three>;
 } // namespace lynx
\ No newline at end of file
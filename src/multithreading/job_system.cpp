@@ -0,0 +1,214 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/multithreading/job_system.hpp"
+#include "lynx/profiling/trace.hpp"
+
+namespace lynx
+{
+static thread_local const job_system *t_system = nullptr;
+static thread_local std::uint32_t t_worker_index = 0;
+
+job_system::job::job(const char *name, std::function<void()> &&task) : m_name(name), m_task(std::move(task))
+{
+}
+
+const char *job_system::job::name() const
+{
+    return m_name;
+}
+bool job_system::job::done() const
+{
+    return m_done.load(std::memory_order_acquire);
+}
+
+job_system::job_system(std::uint32_t workers)
+{
+    if (workers == 0)
+        workers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    m_workers.reserve(workers);
+    for (std::uint32_t i = 0; i < workers; i++)
+        m_workers.push_back(kit::make_scope<worker>());
+    for (std::uint32_t i = 0; i < workers; i++)
+        m_workers[i]->thread = std::thread(&job_system::worker_loop, this, i);
+}
+
+job_system::~job_system()
+{
+    m_stopping.store(true, std::memory_order_release);
+    m_epoch.fetch_add(1, std::memory_order_release);
+    m_epoch.notify_all();
+    for (const auto &wrk : m_workers)
+        wrk->thread.join();
+}
+
+job_system::handle job_system::submit(const char *name, std::function<void()> task,
+                                      const std::vector<handle> &dependencies)
+{
+    KIT_ASSERT_ERROR(name, "Jobs must be named")
+    handle jb = kit::make_ref<job>(name, std::move(task));
+    for (const handle &dependency : dependencies)
+    {
+        const std::scoped_lock lock(dependency->m_mutex);
+        if (dependency->done())
+            continue;
+        jb->m_pending.fetch_add(1, std::memory_order_relaxed);
+        dependency->m_continuations.push_back(jb);
+    }
+    if (jb->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        schedule(jb);
+    return jb;
+}
+
+job_system::handle job_system::then(const handle &parent, const char *name, std::function<void()> task)
+{
+    return submit(name, std::move(task), {parent});
+}
+
+void job_system::wait(const handle &jb)
+{
+    const std::uint32_t index = worker_index();
+    while (!jb->done())
+    {
+        if (const handle other = find_job(index))
+            execute(other);
+        else
+            std::this_thread::yield();
+    }
+}
+void job_system::wait(const std::vector<handle> &jobs)
+{
+    for (const handle &jb : jobs)
+        wait(jb);
+}
+
+void job_system::worker_loop(const std::uint32_t index)
+{
+    t_system = this;
+    t_worker_index = index;
+    while (!m_stopping.load(std::memory_order_acquire))
+    {
+        // The epoch is read before looking for work, so a job scheduled after a failed search always wakes us up
+        const std::uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+        if (const handle jb = find_job(index))
+            execute(jb);
+        else
+            m_epoch.wait(epoch, std::memory_order_acquire);
+    }
+}
+
+void job_system::schedule(handle jb)
+{
+    const std::uint32_t index = worker_index();
+    if (index < m_workers.size())
+    {
+        const std::scoped_lock lock(m_workers[index]->mutex);
+        m_workers[index]->queue.push_back(std::move(jb));
+    }
+    else
+    {
+        const std::scoped_lock lock(m_shared_mutex);
+        m_shared_queue.push_back(std::move(jb));
+    }
+    m_epoch.fetch_add(1, std::memory_order_release);
+    m_epoch.notify_one();
+}
+
+job_system::handle job_system::find_job(const std::uint32_t index)
+{
+    const std::size_t count = m_workers.size();
+    if (index < count)
+    {
+        worker &own = *m_workers[index];
+        const std::scoped_lock lock(own.mutex);
+        if (!own.queue.empty())
+        {
+            handle jb = std::move(own.queue.back());
+            own.queue.pop_back();
+            return jb;
+        }
+    }
+    {
+        const std::scoped_lock lock(m_shared_mutex);
+        if (!m_shared_queue.empty())
+        {
+            handle jb = std::move(m_shared_queue.front());
+            m_shared_queue.pop_front();
+            return jb;
+        }
+    }
+
+    // Victims are visited starting right after the thief, so that thieves spread over different queues
+    for (std::size_t i = 1; i <= count; i++)
+    {
+        const std::size_t victim_index = (index + i) % count;
+        if (victim_index == index)
+            continue;
+        worker &victim = *m_workers[victim_index];
+        const std::scoped_lock lock(victim.mutex);
+        if (!victim.queue.empty())
+        {
+            handle jb = std::move(victim.queue.front());
+            victim.queue.pop_front();
+            m_stolen_jobs.fetch_add(1, std::memory_order_relaxed);
+            return jb;
+        }
+    }
+    return nullptr;
+}
+
+void job_system::execute(const handle &jb)
+{
+    {
+        const trace::scope scope(jb->m_name);
+        jb->m_task();
+    }
+    // Releases whatever the task captured as soon as it is done
+    jb->m_task = nullptr;
+    m_executed_jobs.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<handle> continuations;
+    {
+        const std::scoped_lock lock(jb->m_mutex);
+        jb->m_done.store(true, std::memory_order_release);
+        continuations.swap(jb->m_continuations);
+    }
+    for (handle &continuation : continuations)
+        if (continuation->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(std::move(continuation));
+}
+
+std::uint32_t job_system::worker_count() const
+{
+    return (std::uint32_t)m_workers.size();
+}
+std::uint32_t job_system::worker_index() const
+{
+    return t_system == this ? t_worker_index : worker_count();
+}
+
+scratch_arena &job_system::scratch()
+{
+    const std::uint32_t index = worker_index();
+    if (index < m_workers.size())
+        return m_workers[index]->scratch;
+    KIT_ASSERT_ERROR(std::this_thread::get_id() == m_owner,
+                     "Only workers and the thread that created the job system have a scratch arena")
+    return m_owner_scratch;
+}
+void job_system::reset_scratch()
+{
+    KIT_ASSERT_ERROR(std::this_thread::get_id() == m_owner,
+                     "Scratch arenas may only be reset from the thread that created the job system")
+    for (const auto &wrk : m_workers)
+        wrk->scratch.reset();
+    m_owner_scratch.reset();
+}
+
+std::uint64_t job_system::executed_jobs() const
+{
+    return m_executed_jobs.load(std::memory_order_relaxed);
+}
+std::uint64_t job_system::stolen_jobs() const
+{
+    return m_stolen_jobs.load(std::memory_order_relaxed);
+}
+} // namespace lynx
@@ -0,0 +1,56 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/multithreading/scratch_arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace lynx
+{
+scratch_arena::scratch_arena(const std::size_t block_size) : m_block_size(block_size)
+{
+}
+
+void *scratch_arena::allocate(const std::size_t size, const std::size_t alignment)
+{
+    KIT_ASSERT_ERROR((alignment & (alignment - 1)) == 0, "Alignment must be a power of two")
+    if (!m_blocks.empty())
+    {
+        block &current = m_blocks.back();
+        const std::uintptr_t base = (std::uintptr_t)current.data.get();
+        const std::size_t offset = ((base + m_offset + alignment - 1) & ~(std::uintptr_t)(alignment - 1)) - base;
+        if (offset + size <= current.size)
+        {
+            m_offset = offset + size;
+            m_used += size;
+            return current.data.get() + offset;
+        }
+    }
+
+    const std::size_t grown = m_blocks.empty() ? m_block_size : 2 * m_blocks.back().size;
+    const std::size_t block_size = std::max(grown, size + alignment);
+    m_blocks.push_back({std::unique_ptr<std::byte[]>(new std::byte[block_size]), block_size});
+    m_offset = 0;
+    return allocate(size, alignment);
+}
+
+void scratch_arena::reset()
+{
+    // Blocks only grow, so the last one is the largest
+    if (m_blocks.size() > 1)
+        m_blocks.erase(m_blocks.begin(), m_blocks.end() - 1);
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t scratch_arena::used() const
+{
+    return m_used;
+}
+std::size_t scratch_arena::capacity() const
+{
+    std::size_t capacity = 0;
+    for (const block &blk : m_blocks)
+        capacity += blk.size;
+    return capacity;
+}
+} // namespace lynx
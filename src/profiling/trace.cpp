@@ -0,0 +1,244 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/profiling/trace.hpp"
+#include "lynx/rendering/gpu_profiler.hpp"
+#include "kit/memory/ptr/scope.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+namespace lynx
+{
+struct trace_event
+{
+    const char *name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+struct gpu_trace_event
+{
+    std::string name;
+    std::uint64_t begin;
+    std::uint64_t end;
+};
+
+// Only its owning thread writes to a buffer. The head is published with release semantics after the event is written.
+// Clearing never touches the head, which would race the writer, but moves the tail up to it instead. The tail is only
+// accessed with s_mutex held. Dumping does not stop the writer, so the slots it copies may be overwritten meanwhile:
+// the head is read again after the copy, and every event whose slot the writer may have reached by then is discarded
+struct thread_trace_buffer
+{
+    std::uint32_t id;
+    bool main;
+    std::vector<trace_event> events;
+    std::atomic<std::uint64_t> head{0};
+    std::uint64_t tail = 0;
+};
+
+static std::mutex s_mutex;
+static std::vector<kit::scope<thread_trace_buffer>> s_buffers;
+static std::deque<std::uint64_t> s_frames;
+static std::deque<gpu_trace_event> s_gpu_events;
+static std::size_t s_events_per_thread = 0;
+static std::size_t s_max_frames = 0;
+static std::thread::id s_main_thread;
+
+static thread_local thread_trace_buffer *t_buffer = nullptr;
+
+static thread_trace_buffer *register_thread()
+{
+    std::scoped_lock lock{s_mutex};
+    auto buffer = kit::make_scope<thread_trace_buffer>();
+    buffer->id = (std::uint32_t)s_buffers.size();
+    buffer->main = std::this_thread::get_id() == s_main_thread;
+    buffer->events.resize(s_events_per_thread);
+
+    t_buffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return t_buffer;
+}
+
+trace::scope::scope(const char *name) : m_name(name), m_begin(0)
+{
+    if (s_recording.load(std::memory_order_relaxed))
+        m_begin = now();
+}
+
+trace::scope::~scope()
+{
+    if (m_begin == 0 || !s_recording.load(std::memory_order_relaxed))
+        return;
+    thread_trace_buffer *buffer = t_buffer ? t_buffer : register_thread();
+    const std::uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    // Pairs with the fence in dump: a dump that sees this write also sees the head that announced it
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer->events[head % buffer->events.size()] = {m_name, m_begin, now()};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void trace::start(const std::size_t events_per_thread, const std::size_t max_frames)
+{
+    KIT_ASSERT_ERROR(events_per_thread > 0 && max_frames > 0, "Trace buffers must be able to hold at least one event")
+    KIT_ASSERT_ERROR(!recording(), "A trace is already being recorded")
+    KIT_ASSERT_ERROR(s_buffers.empty() || s_events_per_thread == events_per_thread,
+                     "The events per thread cannot change once threads have registered their buffers")
+    {
+        std::scoped_lock lock{s_mutex};
+        s_events_per_thread = events_per_thread;
+        s_max_frames = max_frames;
+        s_main_thread = std::this_thread::get_id();
+    }
+    s_recording.store(true, std::memory_order_relaxed);
+}
+
+void trace::stop()
+{
+    s_recording.store(false, std::memory_order_relaxed);
+}
+
+bool trace::recording()
+{
+    return s_recording.load(std::memory_order_relaxed);
+}
+
+void trace::clear()
+{
+    std::scoped_lock lock{s_mutex};
+    for (const auto &buffer : s_buffers)
+        buffer->tail = buffer->head.load(std::memory_order_acquire);
+    s_frames.clear();
+    s_gpu_events.clear();
+}
+
+void trace::mark_frame()
+{
+    if (!recording())
+        return;
+    std::scoped_lock lock{s_mutex};
+    if (s_frames.size() == s_max_frames)
+        s_frames.pop_front();
+    s_frames.push_back(now());
+}
+
+void trace::record_gpu(const std::uint64_t anchor, const std::vector<gpu_scope_timing> &timings,
+                       const float frame_milliseconds)
+{
+    if (!recording())
+        return;
+    const auto to_nanoseconds = [](const float ms) { return (std::uint64_t)((double)ms * 1.e6); };
+
+    std::scoped_lock lock{s_mutex};
+    s_gpu_events.push_back({"gpu frame", anchor, anchor + to_nanoseconds(frame_milliseconds)});
+    for (const gpu_scope_timing &timing : timings)
+    {
+        const std::uint64_t begin = anchor + to_nanoseconds(timing.offset_milliseconds);
+        s_gpu_events.push_back({timing.name, begin, begin + to_nanoseconds(timing.milliseconds)});
+    }
+    while (s_gpu_events.size() > s_events_per_thread)
+        s_gpu_events.pop_front();
+}
+
+static void write_escaped(std::ofstream &file, const char *str)
+{
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            file << '\\';
+        file << *str;
+    }
+}
+
+static void write_event(std::ofstream &file, const char *name, const std::uint64_t begin, const std::uint64_t end,
+                        const std::uint64_t origin, const std::uint32_t tid, bool &first)
+{
+    file << (first ? "\n" : ",\n") << "{\"name\": \"";
+    write_escaped(file, name);
+    file << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << tid << ", \"ts\": " << (double)(begin - origin) * 1.e-3
+         << ", \"dur\": " << (double)(end - begin) * 1.e-3 << "}";
+    first = false;
+}
+
+static void write_thread_name(std::ofstream &file, const std::uint32_t tid, const std::string &name, bool &first)
+{
+    file << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << tid
+         << ", \"args\": {\"name\": \"" << name << "\"}}";
+    first = false;
+}
+
+void trace::dump(const std::string &path, const std::size_t last_frames)
+{
+    KIT_PERF_SCOPE("lynx::trace::dump")
+    std::ofstream file{path, std::ios::trunc};
+    KIT_ASSERT_ERROR(file.is_open(), "Failed to open trace file at {0}", path)
+
+    std::scoped_lock lock{s_mutex};
+    std::uint64_t since = 0;
+    if (last_frames > 0 && last_frames < s_frames.size())
+        since = s_frames[s_frames.size() - last_frames];
+
+    std::uint64_t origin = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::vector<trace_event>> thread_events;
+    thread_events.reserve(s_buffers.size());
+    for (const auto &buffer : s_buffers)
+    {
+        const std::uint64_t size = buffer->events.size();
+        const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+        // The slot of the next event is left out, as the writer may already be filling it
+        const std::uint64_t count = std::min<std::uint64_t>(head - buffer->tail, size - 1);
+
+        std::vector<trace_event> copied(count);
+        for (std::uint64_t i = 0; i < count; i++)
+            copied[i] = buffer->events[(head - count + i) % size];
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Event i is overwritten by event i + size, which the writer may have started once the head reaches it
+        const std::uint64_t written = buffer->head.load(std::memory_order_relaxed);
+        std::vector<trace_event> &events = thread_events.emplace_back();
+        events.reserve(count);
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            const trace_event &event = copied[i];
+            if (head - count + i + size > written && event.begin >= since)
+            {
+                events.push_back(event);
+                origin = std::min(origin, event.begin);
+            }
+        }
+    }
+    for (const std::uint64_t frame : s_frames)
+        if (frame >= since)
+            origin = std::min(origin, frame);
+
+    const std::uint32_t gpu_tid = (std::uint32_t)s_buffers.size();
+    const std::uint32_t frames_tid = gpu_tid + 1;
+    bool first = true;
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    for (std::size_t i = 0; i < s_buffers.size(); i++)
+    {
+        const thread_trace_buffer &buffer = *s_buffers[i];
+        write_thread_name(file, buffer.id, buffer.main ? "main" : "thread " + std::to_string(buffer.id), first);
+        for (const trace_event &event : thread_events[i])
+            write_event(file, event.name, event.begin, event.end, origin, buffer.id, first);
+    }
+
+    write_thread_name(file, gpu_tid, "gpu", first);
+    for (const gpu_trace_event &event : s_gpu_events)
+        if (event.begin >= since && event.begin >= origin)
+            write_event(file, event.name.c_str(), event.begin, event.end, origin, gpu_tid, first);
+
+    write_thread_name(file, frames_tid, "frames", first);
+    for (const std::uint64_t frame : s_frames)
+        if (frame >= since)
+            file << ",\n{\"name\": \"frame\", \"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": " << frames_tid
+                 << ", \"ts\": " << (double)(frame - origin) * 1.e-3 << "}";
+    file << "\n]}\n";
+}
+
+std::uint64_t trace::now()
+{
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace lynx
@@ -23,25 +23,23 @@ buffer::buffer(const kit::ref<const device> &dev, const VkDeviceSize instance_si
 
 buffer::~buffer()
 {
-    vkDeviceWaitIdle(m_device->vulkan_device());
+    m_device->wait_idle();
     unmap();
-    vkDestroyBuffer(m_device->vulkan_device(), m_buffer, nullptr);
-    vkFreeMemory(m_device->vulkan_device(), m_memory, nullptr);
+    m_device->destroy_buffer(m_buffer, m_memory);
 }
 
 void buffer::map(VkDeviceSize size, VkDeviceSize offset, VkMemoryMapFlags flags)
 {
     if (m_mapped_data)
         unmap();
-    KIT_CHECK_RETURN_VALUE(vkMapMemory(m_device->vulkan_device(), m_memory, offset, size, flags, &m_mapped_data),
-                           VK_SUCCESS, CRITICAL, "Failed to map memory");
+    m_mapped_data = m_device->map_memory(m_memory, offset, size, flags);
 }
 
 bool buffer::unmap()
 {
     if (!m_mapped_data)
         return false;
-    vkUnmapMemory(m_device->vulkan_device(), m_memory);
+    m_device->unmap_memory(m_memory);
     m_mapped_data = nullptr;
     return true;
 }
@@ -73,21 +71,9 @@ void buffer::write(const buffer &src_buffer)
     m_device->copy_buffer(m_buffer, src_buffer.m_buffer, m_buffer_size);
 }
 
-VkMappedMemoryRange buffer::mapped_memory_range(const VkDeviceSize size, const VkDeviceSize offset)
-{
-    VkMappedMemoryRange mapped_range{};
-    mapped_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-    mapped_range.memory = m_memory;
-    mapped_range.offset = offset;
-    mapped_range.size = size;
-    return mapped_range;
-}
-
 void buffer::flush(const VkDeviceSize size, const VkDeviceSize offset)
 {
-    const VkMappedMemoryRange mapped_range = mapped_memory_range(size, offset);
-    KIT_CHECK_RETURN_VALUE(vkFlushMappedMemoryRanges(m_device->vulkan_device(), 1, &mapped_range), VK_SUCCESS, CRITICAL,
-                           "Failed to flush memory. size: {0}, offset: {1}", size, offset)
+    m_device->flush_memory(m_memory, size, offset);
 }
 
 VkDescriptorBufferInfo buffer::descriptor_info(const VkDeviceSize size, const VkDeviceSize offset) const
@@ -101,9 +87,7 @@ VkDescriptorBufferInfo buffer::descriptor_info(const VkDeviceSize size, const Vk
 
 void buffer::invalidate(const VkDeviceSize size, const VkDeviceSize offset)
 {
-    const VkMappedMemoryRange mapped_range = mapped_memory_range(size, offset);
-    KIT_CHECK_RETURN_VALUE(vkInvalidateMappedMemoryRanges(m_device->vulkan_device(), 1, &mapped_range), VK_SUCCESS,
-                           CRITICAL, "Failed to invalidate memory. size: {0}, offset: {1}", size, offset)
+    m_device->invalidate_memory(m_memory, size, offset);
 }
 
 void buffer::write_at_index(const void *data, std::size_t index)
@@ -0,0 +1,165 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/rendering/compute_pipeline.hpp"
+#include "lynx/rendering/buffer.hpp"
+
+namespace lynx
+{
+compute_pipeline::compute_pipeline(const kit::ref<const device> &dev, const config_info &config)
+    : m_device(dev), m_config(config)
+{
+    KIT_ASSERT_CRITICAL(config.compute_shader_path, "Compute shader path must not be a null pointer!")
+    KIT_ASSERT_ERROR(config.storage_buffer_count > 0, "A compute pipeline must bind at least one storage buffer")
+    KIT_ASSERT_ERROR(config.sets_per_pool > 0, "Descriptor pools must be able to hold at least one set")
+    create_set_layout();
+    create_pipeline_layout();
+    create_pipeline();
+}
+
+compute_pipeline::~compute_pipeline()
+{
+    for (VkDescriptorPool pool : m_pools)
+        m_device->destroy_descriptor_pool(pool);
+    m_device->destroy_shader_module(m_comp_shader_module);
+    m_device->destroy_pipeline(m_compute_pipeline);
+    m_device->destroy_pipeline_layout(m_pipeline_layout);
+    m_device->destroy_descriptor_set_layout(m_set_layout);
+}
+
+void compute_pipeline::bind(VkCommandBuffer command_buffer) const
+{
+    m_device->bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_compute_pipeline);
+}
+
+void compute_pipeline::bind_descriptor_set(VkCommandBuffer command_buffer, VkDescriptorSet set) const
+{
+    m_device->bind_descriptor_set(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline_layout, set);
+}
+
+void compute_pipeline::push_constants(VkCommandBuffer command_buffer, const void *data, const std::uint32_t size) const
+{
+    KIT_ASSERT_ERROR(size <= m_config.constant_range_size,
+                     "Push constant size exceeds the pipeline's constant range. Size: {0}, range: {1}", size,
+                     m_config.constant_range_size)
+    m_device->push_constants(command_buffer, m_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, size, data);
+}
+
+void compute_pipeline::dispatch(VkCommandBuffer command_buffer, const std::uint32_t group_count_x,
+                                const std::uint32_t group_count_y, const std::uint32_t group_count_z) const
+{
+    m_device->dispatch(command_buffer, group_count_x, group_count_y, group_count_z);
+}
+
+VkDescriptorSet compute_pipeline::allocate_descriptor_set()
+{
+    if (m_pools.empty() || m_sets_in_last_pool == m_config.sets_per_pool)
+        create_pool();
+
+    VkDescriptorSetAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    alloc_info.descriptorPool = m_pools.back();
+    alloc_info.descriptorSetCount = 1;
+    alloc_info.pSetLayouts = &m_set_layout;
+
+    m_sets_in_last_pool++;
+    return m_device->allocate_descriptor_set(alloc_info);
+}
+
+void compute_pipeline::write_descriptor_set(VkDescriptorSet set,
+                                            const std::vector<const buffer *> &storage_buffers) const
+{
+    KIT_ASSERT_ERROR(storage_buffers.size() == m_config.storage_buffer_count,
+                     "Storage buffer count mismatch. Expected: {0}, got: {1}", m_config.storage_buffer_count,
+                     storage_buffers.size())
+
+    std::vector<VkDescriptorBufferInfo> buffer_infos;
+    std::vector<VkWriteDescriptorSet> writes;
+    buffer_infos.reserve(storage_buffers.size());
+    writes.reserve(storage_buffers.size());
+    for (std::uint32_t i = 0; i < storage_buffers.size(); i++)
+    {
+        buffer_infos.push_back(storage_buffers[i]->descriptor_info());
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = i;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &buffer_infos.back();
+        writes.push_back(write);
+    }
+    m_device->update_descriptor_sets(writes);
+}
+
+VkPipelineLayout compute_pipeline::pipeline_layout() const
+{
+    return m_pipeline_layout;
+}
+
+void compute_pipeline::create_set_layout()
+{
+    std::vector<VkDescriptorSetLayoutBinding> bindings(m_config.storage_buffer_count);
+    for (std::uint32_t i = 0; i < bindings.size(); i++)
+    {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        bindings[i].pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.bindingCount = (std::uint32_t)bindings.size();
+    layout_info.pBindings = bindings.data();
+    m_set_layout = m_device->create_descriptor_set_layout(layout_info);
+}
+
+void compute_pipeline::create_pipeline_layout()
+{
+    VkPushConstantRange push_constant_range{};
+    push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = m_config.constant_range_size;
+
+    VkPipelineLayoutCreateInfo layout_info{};
+    layout_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layout_info.setLayoutCount = 1;
+    layout_info.pSetLayouts = &m_set_layout;
+    layout_info.pushConstantRangeCount = m_config.constant_range_size > 0 ? 1 : 0;
+    layout_info.pPushConstantRanges = m_config.constant_range_size > 0 ? &push_constant_range : nullptr;
+    m_pipeline_layout = m_device->create_pipeline_layout(layout_info);
+}
+
+void compute_pipeline::create_pipeline()
+{
+    m_comp_shader_module = m_device->create_shader_module(m_config.compute_shader_path);
+
+    VkComputePipelineCreateInfo pipeline_info{};
+    pipeline_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_info.stage.module = m_comp_shader_module;
+    pipeline_info.stage.pName = "main";
+    pipeline_info.layout = m_pipeline_layout;
+    pipeline_info.basePipelineIndex = -1;
+    pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
+    m_compute_pipeline = m_device->create_compute_pipeline(pipeline_info);
+}
+
+void compute_pipeline::create_pool()
+{
+    VkDescriptorPoolSize pool_size{};
+    pool_size.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    pool_size.descriptorCount = m_config.storage_buffer_count * m_config.sets_per_pool;
+
+    VkDescriptorPoolCreateInfo pool_info{};
+    pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_info.maxSets = m_config.sets_per_pool;
+    pool_info.poolSizeCount = 1;
+    pool_info.pPoolSizes = &pool_size;
+
+    m_pools.push_back(m_device->create_descriptor_pool(pool_info));
+    m_sets_in_last_pool = 0;
+}
+} // namespace lynx
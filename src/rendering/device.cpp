@@ -2,6 +2,8 @@
 #include "lynx/app/window.hpp"
 #include "lynx/rendering/device.hpp"
 
+#include <fstream>
+
 namespace lynx
 {
 #ifdef DEBUG
@@ -44,14 +46,31 @@ void destroy_debug_utils_messenger_EXT(VkInstance m_instance, VkDebugUtilsMessen
 }
 #endif
 
-device::device(GLFWwindow *window)
+// Null backend handles are the host allocations themselves, which keeps copies and mappings trivial
+template <typename Handle> static Handle to_null_handle(void *data)
+{
+    return (Handle)(std::uintptr_t)data;
+}
+template <typename Handle> static void *from_null_handle(const Handle handle)
+{
+    return (void *)(std::uintptr_t)handle;
+}
+
+device::device(GLFWwindow *window, const bool null_backend)
+    : m_headless(window == nullptr || null_backend), m_null_backend(null_backend)
 {
+    if (m_null_backend)
+    {
+        create_null_backend();
+        return;
+    }
     create_instance();
 #ifdef DEBUG
     setup_debug_messenger();
 #endif
-    KIT_CHECK_RETURN_VALUE(glfwCreateWindowSurface(m_instance, window, nullptr, &m_surface), VK_SUCCESS, CRITICAL,
-                           "Failed to create GLFW window surface")
+    if (!m_headless)
+        KIT_CHECK_RETURN_VALUE(glfwCreateWindowSurface(m_instance, window, nullptr, &m_surface), VK_SUCCESS, CRITICAL,
+                               "Failed to create GLFW window surface")
     pick_physical_device();
     create_logical_device();
     create_command_pool();
@@ -59,17 +78,69 @@ device::device(GLFWwindow *window)
 
 device::~device()
 {
+    if (m_null_backend)
+        return;
     vkDestroyCommandPool(m_device, m_command_pool, nullptr);
+    vkDestroyCommandPool(m_device, m_transfer_command_pool, nullptr);
     vkDestroyDevice(m_device, nullptr);
 
 #ifdef DEBUG
     destroy_debug_utils_messenger_EXT(m_instance, m_debug_messenger, nullptr);
 #endif
 
-    vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    if (!m_headless)
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
     vkDestroyInstance(m_instance, nullptr);
 }
 
+bool device::headless() const
+{
+    return m_headless;
+}
+bool device::null_backend() const
+{
+    return m_null_backend;
+}
+
+void device::wait_idle() const
+{
+    if (m_null_backend)
+        return;
+    const auto lock = lock_queues();
+    vkDeviceWaitIdle(m_device);
+}
+
+void device::create_null_backend()
+{
+    KIT_INFO("Using the null rendering backend. Nothing will be sent to the gpu")
+    m_instance = VK_NULL_HANDLE;
+    m_device = VK_NULL_HANDLE;
+    m_command_pool = VK_NULL_HANDLE;
+    m_transfer_command_pool = VK_NULL_HANDLE;
+    m_graphics_queue = VK_NULL_HANDLE;
+    m_present_queue = VK_NULL_HANDLE;
+
+    m_properties = {};
+    std::strncpy(m_properties.deviceName, "lynx null device", VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+    m_properties.deviceType = VK_PHYSICAL_DEVICE_TYPE_CPU;
+    m_properties.limits.maxPushConstantsSize = 128;
+    m_properties.limits.nonCoherentAtomSize = 1;
+    m_properties.limits.pointSizeRange[0] = 1.f;
+    m_properties.limits.pointSizeRange[1] = 1024.f;
+
+    m_features = {};
+    m_features.largePoints = VK_TRUE;
+}
+
+std::vector<const char *> device::device_extensions() const
+{
+    std::vector<const char *> extensions(s_device_extensions.begin(), s_device_extensions.end());
+    if (m_headless)
+        extensions.erase(std::find(extensions.begin(), extensions.end(),
+                                   std::string_view(VK_KHR_SWAPCHAIN_EXTENSION_NAME)));
+    return extensions;
+}
+
 bool device::queue_family_indices::is_complete() const
 {
     return graphics_family_has_value && present_family_has_value;
@@ -158,8 +229,13 @@ void device::create_logical_device()
         queue_create_infos.push_back(queue_create_info);
     }
 
-    VkPhysicalDeviceFeatures device_features{};
-    device_features.samplerAnisotropy = VK_TRUE;
+    VkPhysicalDeviceFeatures supported_features;
+    vkGetPhysicalDeviceFeatures(m_physical_device, &supported_features);
+
+    m_features = {};
+    m_features.samplerAnisotropy = VK_TRUE;
+    m_features.largePoints = supported_features.largePoints;
+    m_features.pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery;
 
     VkDeviceCreateInfo create_info{};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
@@ -167,9 +243,10 @@ void device::create_logical_device()
     create_info.queueCreateInfoCount = (std::uint32_t)queue_create_infos.size();
     create_info.pQueueCreateInfos = queue_create_infos.data();
 
-    create_info.pEnabledFeatures = &device_features;
-    create_info.enabledExtensionCount = (std::uint32_t)s_device_extensions.size();
-    create_info.ppEnabledExtensionNames = s_device_extensions.data();
+    create_info.pEnabledFeatures = &m_features;
+    const std::vector<const char *> extensions = device_extensions();
+    create_info.enabledExtensionCount = (std::uint32_t)extensions.size();
+    create_info.ppEnabledExtensionNames = extensions.data();
 
     // might not really be necessary anymore because device specific validation layers
     // have been deprecated
@@ -198,6 +275,10 @@ void device::create_command_pool()
 
     KIT_CHECK_RETURN_VALUE(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_command_pool), VK_SUCCESS, CRITICAL,
                            "Failed to create command pool")
+
+    pool_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    KIT_CHECK_RETURN_VALUE(vkCreateCommandPool(m_device, &pool_info, nullptr, &m_transfer_command_pool), VK_SUCCESS,
+                           CRITICAL, "Failed to create transfer command pool")
 }
 
 bool device::is_device_suitable(const VkPhysicalDevice device) const
@@ -206,8 +287,8 @@ bool device::is_device_suitable(const VkPhysicalDevice device) const
 
     const bool extensions_supported = check_device_extension_support(device);
 
-    bool swap_chain_adequate = false;
-    if (extensions_supported)
+    bool swap_chain_adequate = m_headless;
+    if (extensions_supported && !m_headless)
     {
         const swap_chain_support_details swap_chain_support = query_swap_chain_support(device);
         swap_chain_adequate = !swap_chain_support.formats.empty() && !swap_chain_support.present_modes.empty();
@@ -274,18 +355,21 @@ bool device::check_validation_layer_support() const
 
 std::vector<const char *> device::required_extensions() const
 {
-    std::uint32_t glfw_extension_count = 0;
-    const char **glfw_extensions;
-    glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
-
-    std::vector<const char *> extensions(glfw_extensions, glfw_extensions + glfw_extension_count);
+    std::vector<const char *> extensions;
+    if (!m_headless)
+    {
+        std::uint32_t glfw_extension_count = 0;
+        const char **glfw_extensions = glfwGetRequiredInstanceExtensions(&glfw_extension_count);
+        extensions.insert(extensions.end(), glfw_extensions, glfw_extensions + glfw_extension_count);
+        extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    }
 
 #ifdef DEBUG
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 #endif
     // #ifdef __arm64__
-    extensions.insert(extensions.end(), {VK_KHR_SURFACE_EXTENSION_NAME, VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME,
-                                         "VK_KHR_get_physical_device_properties2"});
+    extensions.insert(extensions.end(),
+                      {VK_KHR_PORTABILITY_ENUMERATION_EXTENSION_NAME, "VK_KHR_get_physical_device_properties2"});
     // #endif
 
     return extensions;
@@ -325,7 +409,8 @@ bool device::check_device_extension_support(VkPhysicalDevice device) const
     std::vector<VkExtensionProperties> availableExtensions(extension_count);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, availableExtensions.data());
 
-    std::unordered_set<std::string> req_extensions(s_device_extensions.begin(), s_device_extensions.end());
+    const std::vector<const char *> extensions = device_extensions();
+    std::unordered_set<std::string> req_extensions(extensions.begin(), extensions.end());
 
     for (const auto &extension : availableExtensions)
         req_extensions.erase(extension.extensionName);
@@ -345,13 +430,19 @@ device::queue_family_indices device::find_queue_families(VkPhysicalDevice device
 
     for (std::uint32_t i = 0; i < queue_families.size(); i++)
     {
-        if (queue_families[i].queueCount > 0 && queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        // Compute pipelines are recorded in the same command buffers as graphics ones
+        const VkQueueFlags required_flags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+        if (queue_families[i].queueCount > 0 && (queue_families[i].queueFlags & required_flags) == required_flags)
         {
             indices.graphics_family = i;
             indices.graphics_family_has_value = true;
         }
+        // Headless devices never present, so the graphics queue doubles as the present queue
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
+        if (m_headless)
+            presentSupport = indices.graphics_family_has_value && indices.graphics_family == i;
+        else
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
         if (queue_families[i].queueCount > 0 && presentSupport)
         {
             indices.present_family = i;
@@ -392,6 +483,8 @@ device::swap_chain_support_details device::query_swap_chain_support(VkPhysicalDe
 VkFormat device::find_supported_format(const std::vector<VkFormat> &candidates, VkImageTiling tiling,
                                        VkFormatFeatureFlags features) const
 {
+    if (m_null_backend)
+        return candidates.front();
     for (VkFormat format : candidates)
     {
         VkFormatProperties props;
@@ -417,9 +510,27 @@ std::uint32_t device::find_memory_type(std::uint32_t typeFilter, VkMemoryPropert
     return (std::uint32_t)-1;
 }
 
+bool device::has_memory_type(const std::uint32_t type_filter, const VkMemoryPropertyFlags properties) const
+{
+    VkPhysicalDeviceMemoryProperties mem_properties;
+    vkGetPhysicalDeviceMemoryProperties(m_physical_device, &mem_properties);
+    for (std::uint32_t i = 0; i < mem_properties.memoryTypeCount; i++)
+        if ((type_filter & (1 << i)) && (mem_properties.memoryTypes[i].propertyFlags & properties) == properties)
+            return true;
+    return false;
+}
+
 void device::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
                            VkBuffer &buffer, VkDeviceMemory &buffer_memory) const
 {
+    if (m_null_backend)
+    {
+        void *data = std::calloc(std::max<VkDeviceSize>(size, 1), 1);
+        buffer = to_null_handle<VkBuffer>(data);
+        buffer_memory = to_null_handle<VkDeviceMemory>(data);
+        track_allocation(buffer_memory, size);
+        return;
+    }
     VkBufferCreateInfo buffer_info{};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     buffer_info.size = size;
@@ -439,15 +550,21 @@ void device::create_buffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemory
 
     KIT_CHECK_RETURN_VALUE(vkAllocateMemory(m_device, &alloc_info, nullptr, &buffer_memory), VK_SUCCESS, CRITICAL,
                            "Failed to allocate buffer memory")
+    track_allocation(buffer_memory, mem_reqs.size);
     vkBindBufferMemory(m_device, buffer, buffer_memory, 0);
 }
 
 VkCommandBuffer device::begin_single_time_commands() const
 {
+    if (m_null_backend)
+        return VK_NULL_HANDLE;
+    // Released by end_single_time_commands
+    m_transfer_mutex.lock();
+
     VkCommandBufferAllocateInfo alloc_info{};
     alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    alloc_info.commandPool = m_command_pool;
+    alloc_info.commandPool = m_transfer_command_pool;
     alloc_info.commandBufferCount = 1;
 
     VkCommandBuffer command_buffer;
@@ -465,6 +582,8 @@ VkCommandBuffer device::begin_single_time_commands() const
 
 void device::end_single_time_commands(VkCommandBuffer command_buffer) const
 {
+    if (m_null_backend)
+        return;
     vkEndCommandBuffer(command_buffer);
 
     VkSubmitInfo submit_info{};
@@ -472,14 +591,23 @@ void device::end_single_time_commands(VkCommandBuffer command_buffer) const
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &command_buffer;
 
-    vkQueueSubmit(m_graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
-    vkQueueWaitIdle(m_graphics_queue);
+    {
+        const auto lock = lock_queues();
+        vkQueueSubmit(m_graphics_queue, 1, &submit_info, VK_NULL_HANDLE);
+        vkQueueWaitIdle(m_graphics_queue);
+    }
 
-    vkFreeCommandBuffers(m_device, m_command_pool, 1, &command_buffer);
+    vkFreeCommandBuffers(m_device, m_transfer_command_pool, 1, &command_buffer);
+    m_transfer_mutex.unlock();
 }
 
 void device::copy_buffer(VkBuffer dst_buffer, VkBuffer src_buffer, VkDeviceSize size) const
 {
+    if (m_null_backend)
+    {
+        std::memcpy(from_null_handle(dst_buffer), from_null_handle(src_buffer), size);
+        return;
+    }
     VkCommandBuffer command_buffer = begin_single_time_commands();
 
     VkBufferCopy copy_region{};
@@ -494,6 +622,8 @@ void device::copy_buffer(VkBuffer dst_buffer, VkBuffer src_buffer, VkDeviceSize
 void device::copy_buffer_to_image(VkBuffer buffer, VkImage image, const std::uint32_t width, const std::uint32_t height,
                                   const std::uint32_t layer_count) const
 {
+    if (m_null_backend)
+        return;
     VkCommandBuffer command_buffer = begin_single_time_commands();
 
     VkBufferImageCopy region{};
@@ -516,11 +646,22 @@ void device::copy_buffer_to_image(VkBuffer buffer, VkImage image, const std::uin
 void device::create_image_with_info(const VkImageCreateInfo &image_info, VkMemoryPropertyFlags properties,
                                     VkImage &image, VkDeviceMemory &image_memory) const
 {
+    if (m_null_backend)
+    {
+        // Images are never sampled nor read back by the null backend, so they get no storage
+        void *data = std::malloc(1);
+        image = to_null_handle<VkImage>(data);
+        image_memory = to_null_handle<VkDeviceMemory>(data);
+        track_allocation(image_memory, 0);
+        return;
+    }
     KIT_CHECK_RETURN_VALUE(vkCreateImage(m_device, &image_info, nullptr, &image), VK_SUCCESS, CRITICAL,
                            "Failed to create image!")
 
     VkMemoryRequirements mem_reqs;
     vkGetImageMemoryRequirements(m_device, image, &mem_reqs);
+    if ((properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) && !has_memory_type(mem_reqs.memoryTypeBits, properties))
+        properties &= ~(VkMemoryPropertyFlags)VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT;
 
     VkMemoryAllocateInfo alloc_info{};
     alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -529,10 +670,350 @@ void device::create_image_with_info(const VkImageCreateInfo &image_info, VkMemor
 
     KIT_CHECK_RETURN_VALUE(vkAllocateMemory(m_device, &alloc_info, nullptr, &image_memory), VK_SUCCESS, CRITICAL,
                            "Failed to allocate image memory")
+    track_allocation(image_memory, mem_reqs.size);
     KIT_CHECK_RETURN_VALUE(vkBindImageMemory(m_device, image, image_memory, 0), VK_SUCCESS, CRITICAL,
                            "Failed to bind image memory")
 }
 
+void device::free_memory(const VkDeviceMemory memory) const
+{
+    if (m_null_backend)
+        std::free(from_null_handle(memory));
+    else
+        vkFreeMemory(m_device, memory, nullptr);
+    const std::scoped_lock lock(m_allocation_mutex);
+    m_allocation_stats.free();
+    const auto it = m_allocations.find(memory);
+    if (it == m_allocations.end())
+        return;
+    m_allocated_memory -= it->second;
+    m_allocations.erase(it);
+}
+
+void device::track_allocation(const VkDeviceMemory memory, const VkDeviceSize size) const
+{
+    const std::scoped_lock lock(m_allocation_mutex);
+    m_allocation_stats.allocate(size);
+    m_allocations.emplace(memory, size);
+    m_allocated_memory += size;
+}
+
+void device::destroy_buffer(const VkBuffer buffer, const VkDeviceMemory buffer_memory) const
+{
+    if (!m_null_backend)
+        vkDestroyBuffer(m_device, buffer, nullptr);
+    free_memory(buffer_memory);
+}
+
+void *device::map_memory(const VkDeviceMemory memory, const VkDeviceSize offset, const VkDeviceSize size,
+                         const VkMemoryMapFlags flags) const
+{
+    if (m_null_backend)
+        return (char *)from_null_handle(memory) + offset;
+
+    void *data;
+    KIT_CHECK_RETURN_VALUE(vkMapMemory(m_device, memory, offset, size, flags, &data), VK_SUCCESS, CRITICAL,
+                           "Failed to map memory")
+    return data;
+}
+void device::unmap_memory(const VkDeviceMemory memory) const
+{
+    if (!m_null_backend)
+        vkUnmapMemory(m_device, memory);
+}
+
+void device::flush_memory(const VkDeviceMemory memory, const VkDeviceSize size, const VkDeviceSize offset) const
+{
+    if (m_null_backend)
+        return;
+    VkMappedMemoryRange mapped_range{};
+    mapped_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mapped_range.memory = memory;
+    mapped_range.offset = offset;
+    mapped_range.size = size;
+    KIT_CHECK_RETURN_VALUE(vkFlushMappedMemoryRanges(m_device, 1, &mapped_range), VK_SUCCESS, CRITICAL,
+                           "Failed to flush memory. size: {0}, offset: {1}", size, offset)
+}
+void device::invalidate_memory(const VkDeviceMemory memory, const VkDeviceSize size, const VkDeviceSize offset) const
+{
+    if (m_null_backend)
+        return;
+    VkMappedMemoryRange mapped_range{};
+    mapped_range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+    mapped_range.memory = memory;
+    mapped_range.offset = offset;
+    mapped_range.size = size;
+    KIT_CHECK_RETURN_VALUE(vkInvalidateMappedMemoryRanges(m_device, 1, &mapped_range), VK_SUCCESS, CRITICAL,
+                           "Failed to invalidate memory. size: {0}, offset: {1}", size, offset)
+}
+
+static std::vector<char> read_file(const char *path)
+{
+    std::ifstream file{path, std::ios::ate | std::ios::binary};
+    KIT_ASSERT_ERROR(file.is_open(), "File at path {0} not found", path)
+
+    const auto file_size = file.tellg();
+    std::vector<char> buffer((std::size_t)file_size);
+
+    file.seekg(0);
+    file.read(buffer.data(), file_size);
+    return buffer;
+}
+
+VkShaderModule device::create_shader_module(const char *path) const
+{
+    if (m_null_backend)
+        return null_handle<VkShaderModule>();
+    const std::vector<char> code = read_file(path);
+
+    VkShaderModuleCreateInfo module_info{};
+    module_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    module_info.codeSize = code.size();
+    module_info.pCode = (const std::uint32_t *)code.data();
+
+    VkShaderModule shader_module;
+    KIT_CHECK_RETURN_VALUE(vkCreateShaderModule(m_device, &module_info, nullptr, &shader_module), VK_SUCCESS, CRITICAL,
+                           "Failed to create shader module")
+    return shader_module;
+}
+VkPipelineLayout device::create_pipeline_layout(const VkPipelineLayoutCreateInfo &layout_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkPipelineLayout>();
+    VkPipelineLayout pipeline_layout;
+    KIT_CHECK_RETURN_VALUE(vkCreatePipelineLayout(m_device, &layout_info, nullptr, &pipeline_layout), VK_SUCCESS,
+                           CRITICAL, "Failed to create pipeline layout")
+    return pipeline_layout;
+}
+VkPipeline device::create_graphics_pipeline(const VkGraphicsPipelineCreateInfo &pipeline_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkPipeline>();
+    VkPipeline pipeline;
+    KIT_CHECK_RETURN_VALUE(vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline),
+                           VK_SUCCESS, CRITICAL, "Failed to create graphics pipeline")
+    return pipeline;
+}
+VkPipeline device::create_compute_pipeline(const VkComputePipelineCreateInfo &pipeline_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkPipeline>();
+    VkPipeline pipeline;
+    KIT_CHECK_RETURN_VALUE(vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_info, nullptr, &pipeline),
+                           VK_SUCCESS, CRITICAL, "Failed to create compute pipeline")
+    return pipeline;
+}
+VkDescriptorSetLayout device::create_descriptor_set_layout(const VkDescriptorSetLayoutCreateInfo &layout_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkDescriptorSetLayout>();
+    VkDescriptorSetLayout set_layout;
+    KIT_CHECK_RETURN_VALUE(vkCreateDescriptorSetLayout(m_device, &layout_info, nullptr, &set_layout), VK_SUCCESS,
+                           CRITICAL, "Failed to create descriptor set layout")
+    return set_layout;
+}
+VkDescriptorPool device::create_descriptor_pool(const VkDescriptorPoolCreateInfo &pool_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkDescriptorPool>();
+    VkDescriptorPool pool;
+    KIT_CHECK_RETURN_VALUE(vkCreateDescriptorPool(m_device, &pool_info, nullptr, &pool), VK_SUCCESS, CRITICAL,
+                           "Failed to create descriptor pool")
+    return pool;
+}
+VkDescriptorSet device::allocate_descriptor_set(const VkDescriptorSetAllocateInfo &alloc_info) const
+{
+    if (m_null_backend)
+        return null_handle<VkDescriptorSet>();
+    VkDescriptorSet set;
+    KIT_CHECK_RETURN_VALUE(vkAllocateDescriptorSets(m_device, &alloc_info, &set), VK_SUCCESS, CRITICAL,
+                           "Failed to allocate descriptor set")
+    return set;
+}
+void device::update_descriptor_sets(const std::vector<VkWriteDescriptorSet> &writes) const
+{
+    if (!m_null_backend)
+        vkUpdateDescriptorSets(m_device, (std::uint32_t)writes.size(), writes.data(), 0, nullptr);
+}
+
+void device::destroy_shader_module(const VkShaderModule shader_module) const
+{
+    if (!m_null_backend)
+        vkDestroyShaderModule(m_device, shader_module, nullptr);
+}
+void device::destroy_pipeline_layout(const VkPipelineLayout pipeline_layout) const
+{
+    if (!m_null_backend)
+        vkDestroyPipelineLayout(m_device, pipeline_layout, nullptr);
+}
+void device::destroy_pipeline(const VkPipeline pipeline) const
+{
+    if (!m_null_backend)
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+}
+void device::destroy_descriptor_set_layout(const VkDescriptorSetLayout set_layout) const
+{
+    if (!m_null_backend)
+        vkDestroyDescriptorSetLayout(m_device, set_layout, nullptr);
+}
+void device::destroy_descriptor_pool(const VkDescriptorPool pool) const
+{
+    if (!m_null_backend)
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+}
+
+void device::allocate_command_buffers(VkCommandBuffer *command_buffers, const std::uint32_t count) const
+{
+    // Placeholders are never handed to Vulkan, only compared against each other
+    if (m_null_backend)
+    {
+        for (std::uint32_t i = 0; i < count; i++)
+            command_buffers[i] = reinterpret_cast<VkCommandBuffer>((std::uintptr_t)i + 1);
+        return;
+    }
+    VkCommandBufferAllocateInfo alloc_info{};
+    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    alloc_info.commandPool = m_command_pool;
+    alloc_info.commandBufferCount = count;
+    KIT_CHECK_RETURN_VALUE(vkAllocateCommandBuffers(m_device, &alloc_info, command_buffers), VK_SUCCESS, CRITICAL,
+                           "Failed to create command buffers")
+}
+void device::free_command_buffers(const VkCommandBuffer *command_buffers, const std::uint32_t count) const
+{
+    if (!m_null_backend)
+        vkFreeCommandBuffers(m_device, m_command_pool, count, command_buffers);
+}
+void device::begin_command_buffer(const VkCommandBuffer command_buffer) const
+{
+    if (m_null_backend)
+        return;
+    VkCommandBufferBeginInfo begin_info{};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+
+    KIT_CHECK_RETURN_VALUE(vkResetCommandBuffer(command_buffer, 0), VK_SUCCESS, CRITICAL,
+                           "Failed to reset command buffer")
+    KIT_CHECK_RETURN_VALUE(vkBeginCommandBuffer(command_buffer, &begin_info), VK_SUCCESS, CRITICAL,
+                           "Failed to begin command buffer")
+}
+void device::end_command_buffer(const VkCommandBuffer command_buffer) const
+{
+    if (m_null_backend)
+        return;
+    KIT_CHECK_RETURN_VALUE(vkEndCommandBuffer(command_buffer), VK_SUCCESS, CRITICAL, "Failed to end command buffer")
+}
+
+void device::begin_render_pass(const VkCommandBuffer command_buffer, const VkRenderPassBeginInfo &pass_info) const
+{
+    if (!m_null_backend)
+        vkCmdBeginRenderPass(command_buffer, &pass_info, VK_SUBPASS_CONTENTS_INLINE);
+}
+void device::end_render_pass(const VkCommandBuffer command_buffer) const
+{
+    if (!m_null_backend)
+        vkCmdEndRenderPass(command_buffer);
+}
+void device::set_viewport(const VkCommandBuffer command_buffer, const VkViewport &viewport) const
+{
+    if (!m_null_backend)
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+}
+void device::set_scissor(const VkCommandBuffer command_buffer, const VkRect2D &scissor) const
+{
+    if (!m_null_backend)
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+}
+
+void device::bind_pipeline(const VkCommandBuffer command_buffer, const VkPipelineBindPoint bind_point,
+                           const VkPipeline pipeline) const
+{
+    m_stats.bind_pipeline();
+    if (!m_null_backend)
+        vkCmdBindPipeline(command_buffer, bind_point, pipeline);
+}
+void device::bind_descriptor_set(const VkCommandBuffer command_buffer, const VkPipelineBindPoint bind_point,
+                                 const VkPipelineLayout layout, const VkDescriptorSet set) const
+{
+    if (!m_null_backend)
+        vkCmdBindDescriptorSets(command_buffer, bind_point, layout, 0, 1, &set, 0, nullptr);
+}
+void device::push_constants(const VkCommandBuffer command_buffer, const VkPipelineLayout layout,
+                            const VkShaderStageFlags stages, const std::uint32_t size, const void *data) const
+{
+    m_stats.push_constants(size);
+    if (!m_null_backend)
+        vkCmdPushConstants(command_buffer, layout, stages, 0, size, data);
+}
+void device::bind_vertex_buffer(const VkCommandBuffer command_buffer, const VkBuffer buffer) const
+{
+    m_stats.bind_vertex_buffers();
+    const VkDeviceSize offset = 0;
+    if (!m_null_backend)
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, &buffer, &offset);
+}
+void device::bind_index_buffer(const VkCommandBuffer command_buffer, const VkBuffer buffer) const
+{
+    m_stats.bind_index_buffer();
+    if (!m_null_backend)
+        vkCmdBindIndexBuffer(command_buffer, buffer, 0, VK_INDEX_TYPE_UINT32);
+}
+void device::draw(const VkCommandBuffer command_buffer, const std::uint32_t vertex_count,
+                  const std::uint32_t instance_count, const std::uint32_t first_vertex) const
+{
+    m_stats.draw(vertex_count, instance_count);
+    if (!m_null_backend)
+        vkCmdDraw(command_buffer, vertex_count, instance_count, first_vertex, 0);
+}
+void device::draw_indexed(const VkCommandBuffer command_buffer, const std::uint32_t index_count,
+                          const std::uint32_t instance_count) const
+{
+    m_stats.draw_indexed(index_count, instance_count);
+    if (!m_null_backend)
+        vkCmdDrawIndexed(command_buffer, index_count, instance_count, 0, 0, 0);
+}
+void device::dispatch(const VkCommandBuffer command_buffer, const std::uint32_t group_count_x,
+                      const std::uint32_t group_count_y, const std::uint32_t group_count_z) const
+{
+    m_stats.dispatch();
+    if (!m_null_backend)
+        vkCmdDispatch(command_buffer, group_count_x, group_count_y, group_count_z);
+}
+void device::pipeline_barrier(const VkCommandBuffer command_buffer, const VkPipelineStageFlags src_stages,
+                              const VkPipelineStageFlags dst_stages, const VkMemoryBarrier *barrier) const
+{
+    if (!m_null_backend)
+        vkCmdPipelineBarrier(command_buffer, src_stages, dst_stages, 0, barrier ? 1 : 0, barrier, 0, nullptr, 0,
+                             nullptr);
+}
+
+render_stats &device::stats() const
+{
+    return m_stats;
+}
+void device::collect_allocation_stats(render_stats &stats) const
+{
+    const std::scoped_lock lock(m_allocation_mutex);
+    stats.allocations += m_allocation_stats.allocations;
+    stats.frees += m_allocation_stats.frees;
+    stats.allocated_bytes += m_allocation_stats.allocated_bytes;
+    m_allocation_stats = {};
+}
+VkDeviceSize device::allocated_memory() const
+{
+    const std::scoped_lock lock(m_allocation_mutex);
+    return m_allocated_memory;
+}
+std::size_t device::allocation_count() const
+{
+    const std::scoped_lock lock(m_allocation_mutex);
+    return m_allocations.size();
+}
+
+std::unique_lock<std::mutex> device::lock_queues() const
+{
+    return std::unique_lock<std::mutex>(m_queue_mutex);
+}
+
 VkCommandPool device::command_pool() const
 {
     return m_command_pool;
@@ -566,6 +1047,10 @@ VkPhysicalDeviceProperties device::properties() const
 {
     return m_properties;
 }
+VkPhysicalDeviceFeatures device::features() const
+{
+    return m_features;
+}
 
 device::swap_chain_support_details device::swap_chain_support() const
 {
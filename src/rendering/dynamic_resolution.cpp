@@ -0,0 +1,320 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/rendering/dynamic_resolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lynx
+{
+dynamic_resolution::dynamic_resolution(const kit::ref<const device> &dev, const swap_chain &swpc, const specs &spc)
+    : m_device(dev), m_specs(spc), m_scale(spc.max_scale), m_headless(dev->headless())
+{
+    KIT_ASSERT_ERROR(!dev->null_backend(), "Dynamic resolution is not available with the null backend")
+    KIT_ASSERT_ERROR(spc.min_scale > 0.f && spc.min_scale <= spc.max_scale && spc.max_scale <= 1.f,
+                     "Dynamic resolution scales must satisfy 0 < min <= max <= 1")
+    KIT_ASSERT_ERROR(spc.target_milliseconds > 0.f, "The frame time budget must be greater than 0")
+    create(swpc);
+}
+
+dynamic_resolution::~dynamic_resolution()
+{
+    destroy();
+}
+
+void dynamic_resolution::resize(const swap_chain &swpc)
+{
+    destroy();
+    create(swpc);
+    m_generation++;
+}
+
+void dynamic_resolution::create(const swap_chain &swpc)
+{
+    m_extent = swpc.extent();
+    m_color_format = swpc.swap_chain_image_format();
+    m_depth_format = swpc.find_depth_format();
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(m_device->vulkan_physical_device(), m_color_format, &props);
+    KIT_ASSERT_ERROR((props.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT) &&
+                         (props.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT),
+                     "The swap chain format does not support blits, which upscaling relies on")
+    m_filter = (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ? VK_FILTER_LINEAR
+                                                                                                : VK_FILTER_NEAREST;
+    create_images();
+    create_render_passes();
+    create_frame_buffers(swpc);
+}
+
+void dynamic_resolution::destroy()
+{
+    const VkDevice dev = m_device->vulkan_device();
+    for (const VkFramebuffer frame_buffer : m_composite_frame_buffers)
+        vkDestroyFramebuffer(dev, frame_buffer, nullptr);
+    m_composite_frame_buffers.clear();
+    vkDestroyFramebuffer(dev, m_frame_buffer, nullptr);
+    vkDestroyRenderPass(dev, m_composite_render_pass, nullptr);
+    vkDestroyRenderPass(dev, m_render_pass, nullptr);
+
+    vkDestroyImageView(dev, m_depth_view, nullptr);
+    vkDestroyImage(dev, m_depth_image, nullptr);
+    m_device->free_memory(m_depth_memory);
+    vkDestroyImageView(dev, m_color_view, nullptr);
+    vkDestroyImage(dev, m_color_image, nullptr);
+    m_device->free_memory(m_color_memory);
+}
+
+void dynamic_resolution::create_images()
+{
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent.width = m_extent.width;
+    image_info.extent.height = m_extent.height;
+    image_info.extent.depth = 1;
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.format = m_color_format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    image_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    m_device->create_image_with_info(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_color_image, m_color_memory);
+    m_color_view = create_view(m_color_image, m_color_format, VK_IMAGE_ASPECT_COLOR_BIT);
+
+    // Shared by the scene and the composite passes, and never stored by either of them
+    image_info.format = m_depth_format;
+    image_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    m_device->create_image_with_info(image_info,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                                     m_depth_image, m_depth_memory);
+    m_depth_view = create_view(m_depth_image, m_depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+}
+
+VkImageView dynamic_resolution::create_view(const VkImage image, const VkFormat format,
+                                            const VkImageAspectFlags aspect) const
+{
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = format;
+    view_info.subresourceRange.aspectMask = aspect;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    VkImageView view;
+    KIT_CHECK_RETURN_VALUE(vkCreateImageView(m_device->vulkan_device(), &view_info, nullptr, &view), VK_SUCCESS,
+                           CRITICAL, "Failed to create dynamic resolution image view")
+    return view;
+}
+
+// Both passes have the same attachments as the swap chain's, so that pipelines created for it can be used in them
+void dynamic_resolution::create_render_passes()
+{
+    VkAttachmentDescription color_attachment{};
+    color_attachment.format = m_color_format;
+    color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color_attachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+    VkAttachmentDescription depth_attachment{};
+    depth_attachment.format = m_depth_format;
+    depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depth_attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference color_attachment_ref{0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depth_attachment_ref{1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
+
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_attachment_ref;
+    subpass.pDepthStencilAttachment = &depth_attachment_ref;
+
+    // The previous frame's blit must have read the color target, and every earlier depth write must have completed,
+    // before they are cleared. The blit that follows waits for the color writes
+    std::array<VkSubpassDependency, 2> dependencies{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                                   VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                                   VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    std::array<VkAttachmentDescription, 2> attachments = {color_attachment, depth_attachment};
+    VkRenderPassCreateInfo render_pass_info{};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_info.attachmentCount = (std::uint32_t)attachments.size();
+    render_pass_info.pAttachments = attachments.data();
+    render_pass_info.subpassCount = 1;
+    render_pass_info.pSubpasses = &subpass;
+    render_pass_info.dependencyCount = (std::uint32_t)dependencies.size();
+    render_pass_info.pDependencies = dependencies.data();
+
+    KIT_CHECK_RETURN_VALUE(vkCreateRenderPass(m_device->vulkan_device(), &render_pass_info, nullptr, &m_render_pass),
+                           VK_SUCCESS, CRITICAL, "Failed to create dynamic resolution render pass")
+
+    // The composite pass keeps the upscaled image in the swap chain and leaves it as the swap chain's own pass would
+    attachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    attachments[0].initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    attachments[0].finalLayout = m_headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkSubpassDependency composite_dependency{};
+    composite_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    composite_dependency.dstSubpass = 0;
+    composite_dependency.srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    composite_dependency.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    composite_dependency.dstStageMask =
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    composite_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    render_pass_info.dependencyCount = 1;
+    render_pass_info.pDependencies = &composite_dependency;
+    KIT_CHECK_RETURN_VALUE(
+        vkCreateRenderPass(m_device->vulkan_device(), &render_pass_info, nullptr, &m_composite_render_pass),
+        VK_SUCCESS, CRITICAL, "Failed to create dynamic resolution composite render pass")
+}
+
+void dynamic_resolution::create_frame_buffers(const swap_chain &swpc)
+{
+    VkFramebufferCreateInfo frame_buffer_info{};
+    frame_buffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    frame_buffer_info.renderPass = m_render_pass;
+    frame_buffer_info.attachmentCount = 2;
+    frame_buffer_info.width = m_extent.width;
+    frame_buffer_info.height = m_extent.height;
+    frame_buffer_info.layers = 1;
+
+    std::array<VkImageView, 2> attachments = {m_color_view, m_depth_view};
+    frame_buffer_info.pAttachments = attachments.data();
+    KIT_CHECK_RETURN_VALUE(
+        vkCreateFramebuffer(m_device->vulkan_device(), &frame_buffer_info, nullptr, &m_frame_buffer), VK_SUCCESS,
+        CRITICAL, "Failed to create dynamic resolution frame buffer")
+
+    frame_buffer_info.renderPass = m_composite_render_pass;
+    m_composite_frame_buffers.resize(swpc.image_count());
+    for (std::size_t i = 0; i < m_composite_frame_buffers.size(); i++)
+    {
+        attachments[0] = swpc.image_view(i);
+        KIT_CHECK_RETURN_VALUE(vkCreateFramebuffer(m_device->vulkan_device(), &frame_buffer_info, nullptr,
+                                                   &m_composite_frame_buffers[i]),
+                               VK_SUCCESS, CRITICAL, "Failed to create dynamic resolution composite frame buffer")
+    }
+}
+
+void dynamic_resolution::update(const float gpu_milliseconds, const std::uint32_t generation)
+{
+    if (gpu_milliseconds <= 0.f || generation != m_generation)
+        return;
+    const float ratio = m_specs.target_milliseconds / gpu_milliseconds;
+    if (std::abs(ratio - 1.f) < m_specs.tolerance)
+        return;
+    const float ideal = m_scale * std::sqrt(ratio);
+    scale(m_scale + (ideal - m_scale) * m_specs.gain);
+}
+
+// Must be recorded between the scene and the composite passes
+void dynamic_resolution::upscale(VkCommandBuffer command_buffer, const VkImage swap_chain_image) const
+{
+    LYNX_TRACE_SCOPE("lynx::dynamic_resolution::upscale")
+    VkImageMemoryBarrier to_transfer{};
+    to_transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    to_transfer.srcAccessMask = 0;
+    to_transfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    to_transfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    to_transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.image = swap_chain_image;
+    to_transfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    // The swap chain image is acquired at the color attachment output stage, so the barrier chains from it
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &to_transfer);
+
+    const VkExtent2D scaled = scaled_extent();
+    VkImageBlit blit{};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {(std::int32_t)scaled.width, (std::int32_t)scaled.height, 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {(std::int32_t)m_extent.width, (std::int32_t)m_extent.height, 1};
+    vkCmdBlitImage(command_buffer, m_color_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, swap_chain_image,
+                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, m_filter);
+}
+
+float dynamic_resolution::scale() const
+{
+    return m_scale;
+}
+void dynamic_resolution::scale(const float scale)
+{
+    const float clamped = std::clamp(scale, m_specs.min_scale, m_specs.max_scale);
+    if (clamped == m_scale)
+        return;
+    m_scale = clamped;
+    m_generation++;
+}
+
+float dynamic_resolution::target_milliseconds() const
+{
+    return m_specs.target_milliseconds;
+}
+void dynamic_resolution::target_milliseconds(const float target)
+{
+    KIT_ASSERT_ERROR(target > 0.f, "The frame time budget must be greater than 0")
+    m_specs.target_milliseconds = target;
+}
+
+VkExtent2D dynamic_resolution::scaled_extent() const
+{
+    return {std::max(1u, (std::uint32_t)std::lround((float)m_extent.width * m_scale)),
+            std::max(1u, (std::uint32_t)std::lround((float)m_extent.height * m_scale))};
+}
+std::uint32_t dynamic_resolution::generation() const
+{
+    return m_generation;
+}
+
+VkRenderPass dynamic_resolution::render_pass() const
+{
+    return m_render_pass;
+}
+VkFramebuffer dynamic_resolution::frame_buffer() const
+{
+    return m_frame_buffer;
+}
+VkRenderPass dynamic_resolution::composite_render_pass() const
+{
+    return m_composite_render_pass;
+}
+VkFramebuffer dynamic_resolution::composite_frame_buffer(const std::size_t image_index) const
+{
+    return m_composite_frame_buffers[image_index];
+}
+} // namespace lynx
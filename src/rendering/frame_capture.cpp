@@ -0,0 +1,364 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/rendering/frame_capture.hpp"
+
+#include <algorithm>
+
+namespace lynx
+{
+frame_capture::frame_capture(const kit::ref<const device> &dev, const specs &spc) : m_device(dev), m_specs(spc)
+{
+    KIT_ASSERT_ERROR(spc.framerate > 0, "Capture framerate must be greater than 0")
+    if (spc.fmt != format::PNG_SEQUENCE)
+    {
+        m_stream.open(spc.path, std::ios::binary | std::ios::trunc);
+        KIT_ASSERT_ERROR(m_stream.is_open(), "Failed to open capture file at {0}", spc.path)
+    }
+    start_writer();
+}
+
+frame_capture::frame_capture(const kit::ref<const device> &dev, callback on_frame)
+    : m_device(dev), m_on_frame(std::move(on_frame))
+{
+    KIT_ASSERT_ERROR(m_on_frame, "Capture callback must not be empty")
+    start_writer();
+}
+
+frame_capture::~frame_capture()
+{
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_writer.join();
+    if (m_dropped_frames > 0)
+        KIT_WARN("Frame capture dropped {0} of {1} frames because the writer could not keep up", m_dropped_frames,
+                 m_frame_count)
+}
+
+void frame_capture::start_writer()
+{
+    m_writer = std::thread(&frame_capture::writer_loop, this);
+}
+
+void frame_capture::record(VkCommandBuffer command_buffer, VkImage image, const VkFormat image_format,
+                           const VkExtent2D extent, const VkImageLayout image_layout, const std::uint32_t frame_index)
+{
+    LYNX_TRACE_SCOPE("lynx::frame_capture::record")
+    slot &sl = m_slots[frame_index];
+    KIT_ASSERT_ERROR(!sl.pending, "Capture slot {0} has not been read back yet", frame_index)
+
+    const std::size_t pixel_count = (std::size_t)extent.width * extent.height;
+    if (!sl.staging || sl.staging->instance_count() != pixel_count)
+    {
+        sl.staging = kit::make_scope<buffer>(m_device, 4, pixel_count, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        sl.staging->map();
+    }
+
+    VkImageMemoryBarrier to_transfer{};
+    to_transfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    to_transfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    to_transfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    to_transfer.oldLayout = image_layout;
+    to_transfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    to_transfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_transfer.image = image;
+    to_transfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &to_transfer);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageOffset = {0, 0, 0};
+    region.imageExtent = {extent.width, extent.height, 1};
+    vkCmdCopyImageToBuffer(command_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, sl.staging->vulkan_buffer(), 1,
+                           &region);
+
+    VkBufferMemoryBarrier to_host{};
+    to_host.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    to_host.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    to_host.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    to_host.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_host.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    to_host.buffer = sl.staging->vulkan_buffer();
+    to_host.offset = 0;
+    to_host.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                         &to_host, 0, nullptr);
+
+    if (image_layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+    {
+        VkImageMemoryBarrier to_original = to_transfer;
+        to_original.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        to_original.dstAccessMask = 0;
+        to_original.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        to_original.newLayout = image_layout;
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                             0, nullptr, 0, nullptr, 1, &to_original);
+    }
+
+    sl.extent = extent;
+    sl.image_format = image_format;
+    sl.index = m_frame_count++;
+    sl.pending = true;
+}
+
+static bool is_bgra(const VkFormat format)
+{
+    return format == VK_FORMAT_B8G8R8A8_UNORM || format == VK_FORMAT_B8G8R8A8_SRGB ||
+           format == VK_FORMAT_B8G8R8A8_SNORM;
+}
+
+void frame_capture::read(const std::uint32_t frame_index)
+{
+    slot &sl = m_slots[frame_index];
+    if (!sl.pending)
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::frame_capture::read")
+    sl.pending = false;
+    {
+        // Only this thread pushes, so the queue cannot fill up again before the frame is pushed
+        std::scoped_lock lock(m_mutex);
+        if (m_queue.size() >= MAX_PENDING_FRAMES)
+        {
+            m_dropped_frames++;
+            return;
+        }
+    }
+
+    captured_frame frame{sl.index, sl.extent.width, sl.extent.height, {}};
+    const std::size_t size = (std::size_t)sl.extent.width * sl.extent.height * 4;
+    frame.pixels.resize(size);
+
+    const std::uint8_t *src = &sl.staging->read_at_index<std::uint8_t>(0);
+    std::memcpy(frame.pixels.data(), src, size);
+    if (is_bgra(sl.image_format))
+        for (std::size_t i = 0; i < size; i += 4)
+            std::swap(frame.pixels[i], frame.pixels[i + 2]);
+
+    {
+        std::scoped_lock lock(m_mutex);
+        m_queue.push(std::move(frame));
+    }
+    m_cv.notify_one();
+}
+
+void frame_capture::read_all()
+{
+    m_device->wait_idle();
+
+    // Slots are read in capture order so that streams stay sorted
+    std::array<std::uint32_t, swap_chain::MAX_FRAMES_IN_FLIGHT> order;
+    for (std::uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [this](const std::uint32_t a, const std::uint32_t b) { return m_slots[a].index < m_slots[b].index; });
+    for (const std::uint32_t i : order)
+        read(i);
+}
+
+std::uint64_t frame_capture::captured_frames() const
+{
+    return m_frame_count;
+}
+std::size_t frame_capture::pending_frames() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_queue.size();
+}
+std::uint64_t frame_capture::dropped_frames() const
+{
+    std::scoped_lock lock(m_mutex);
+    return m_dropped_frames;
+}
+
+void frame_capture::writer_loop()
+{
+    for (;;)
+    {
+        captured_frame frame;
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+                return;
+            frame = std::move(m_queue.front());
+            m_queue.pop();
+        }
+        if (m_on_frame)
+            m_on_frame(frame);
+        else
+            write(frame);
+    }
+}
+
+static std::uint32_t crc32(const std::uint8_t *data, const std::size_t size, std::uint32_t crc = 0xFFFFFFFF)
+{
+    static const std::array<std::uint32_t, 256> table = []() {
+        std::array<std::uint32_t, 256> tbl;
+        for (std::uint32_t i = 0; i < 256; i++)
+        {
+            std::uint32_t c = i;
+            for (std::uint32_t k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            tbl[i] = c;
+        }
+        return tbl;
+    }();
+    for (std::size_t i = 0; i < size; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void push_u32_be(std::vector<std::uint8_t> &out, const std::uint32_t value)
+{
+    out.push_back((std::uint8_t)(value >> 24));
+    out.push_back((std::uint8_t)(value >> 16));
+    out.push_back((std::uint8_t)(value >> 8));
+    out.push_back((std::uint8_t)value);
+}
+
+static void write_png_chunk(std::ofstream &file, const char *type, const std::vector<std::uint8_t> &data)
+{
+    std::vector<std::uint8_t> chunk;
+    chunk.reserve(data.size() + 12);
+    push_u32_be(chunk, (std::uint32_t)data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    push_u32_be(chunk, crc32(chunk.data() + 4, data.size() + 4) ^ 0xFFFFFFFF);
+    file.write((const char *)chunk.data(), (std::streamsize)chunk.size());
+}
+
+// Encodes the image with stored (uncompressed) deflate blocks. Files are larger than compressed pngs, but encoding is
+// just a copy, which keeps the writer thread ahead of the frame loop
+static void write_png(const std::string &path, const captured_frame &frame)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    KIT_ASSERT_ERROR(file.is_open(), "Failed to open capture file at {0}", path)
+
+    static constexpr std::array<std::uint8_t, 8> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.write((const char *)signature.data(), signature.size());
+
+    std::vector<std::uint8_t> header;
+    push_u32_be(header, frame.width);
+    push_u32_be(header, frame.height);
+    header.insert(header.end(), {8, 6, 0, 0, 0}); // 8 bit depth, RGBA, deflate, no filter, no interlace
+    write_png_chunk(file, "IHDR", header);
+
+    const std::size_t row_size = (std::size_t)frame.width * 4;
+    std::vector<std::uint8_t> raw;
+    raw.reserve((row_size + 1) * frame.height);
+    for (std::uint32_t y = 0; y < frame.height; y++)
+    {
+        raw.push_back(0);
+        const std::uint8_t *row = frame.pixels.data() + y * row_size;
+        raw.insert(raw.end(), row, row + row_size);
+    }
+
+    static constexpr std::size_t max_block = 65535;
+    std::vector<std::uint8_t> zlib;
+    zlib.reserve(raw.size() + 6 + 5 * (raw.size() / max_block + 1));
+    zlib.insert(zlib.end(), {0x78, 0x01});
+
+    std::uint32_t a = 1, b = 0;
+    for (std::size_t offset = 0; offset < raw.size() || offset == 0; offset += max_block)
+    {
+        const std::size_t len = std::min(max_block, raw.size() - offset);
+        const bool last = offset + len >= raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((std::uint8_t)(len & 0xFF));
+        zlib.push_back((std::uint8_t)(len >> 8));
+        zlib.push_back((std::uint8_t)(~len & 0xFF));
+        zlib.push_back((std::uint8_t)((~len >> 8) & 0xFF));
+        zlib.insert(zlib.end(), raw.begin() + (std::ptrdiff_t)offset, raw.begin() + (std::ptrdiff_t)(offset + len));
+        for (std::size_t i = offset; i < offset + len; i++)
+        {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        if (last)
+            break;
+    }
+    push_u32_be(zlib, (b << 16) | a);
+    write_png_chunk(file, "IDAT", zlib);
+    write_png_chunk(file, "IEND", {});
+}
+
+static void write_y4m_frame(std::ofstream &file, const captured_frame &frame)
+{
+    const std::uint32_t w = frame.width;
+    const std::uint32_t h = frame.height;
+    const std::uint32_t cw = (w + 1) / 2;
+    const std::uint32_t ch = (h + 1) / 2;
+
+    std::vector<std::uint8_t> planes((std::size_t)w * h + 2 * (std::size_t)cw * ch);
+    std::uint8_t *y_plane = planes.data();
+    std::uint8_t *u_plane = y_plane + (std::size_t)w * h;
+    std::uint8_t *v_plane = u_plane + (std::size_t)cw * ch;
+
+    const auto pixel = [&frame, w](const std::uint32_t x, const std::uint32_t y) {
+        const std::uint8_t *p = frame.pixels.data() + ((std::size_t)y * w + x) * 4;
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    for (std::uint32_t y = 0; y < h; y++)
+        for (std::uint32_t x = 0; x < w; x++)
+        {
+            const glm::vec3 rgb = pixel(x, y);
+            y_plane[(std::size_t)y * w + x] =
+                (std::uint8_t)glm::clamp(0.299f * rgb.r + 0.587f * rgb.g + 0.114f * rgb.b, 0.f, 255.f);
+        }
+
+    // Full range BT.601 (C420jpeg), averaging each 2x2 block for the chroma planes
+    for (std::uint32_t y = 0; y < ch; y++)
+        for (std::uint32_t x = 0; x < cw; x++)
+        {
+            const std::uint32_t x0 = 2 * x, y0 = 2 * y;
+            const std::uint32_t x1 = std::min(x0 + 1, w - 1), y1 = std::min(y0 + 1, h - 1);
+            const glm::vec3 rgb = 0.25f * (pixel(x0, y0) + pixel(x1, y0) + pixel(x0, y1) + pixel(x1, y1));
+            u_plane[(std::size_t)y * cw + x] =
+                (std::uint8_t)glm::clamp(128.f - 0.168736f * rgb.r - 0.331264f * rgb.g + 0.5f * rgb.b, 0.f, 255.f);
+            v_plane[(std::size_t)y * cw + x] =
+                (std::uint8_t)glm::clamp(128.f + 0.5f * rgb.r - 0.418688f * rgb.g - 0.081312f * rgb.b, 0.f, 255.f);
+        }
+
+    file << "FRAME\n";
+    file.write((const char *)planes.data(), (std::streamsize)planes.size());
+}
+
+void frame_capture::write(const captured_frame &frame)
+{
+    LYNX_TRACE_SCOPE("lynx::frame_capture::write")
+    if (m_specs.fmt == format::PNG_SEQUENCE)
+    {
+        const std::string index = std::to_string(frame.index);
+        write_png(m_specs.path + std::string(index.size() < 6 ? 6 - index.size() : 0, '0') + index + ".png", frame);
+        return;
+    }
+
+    // Streams cannot change their resolution midway
+    if (m_stream_extent.width == 0)
+    {
+        m_stream_extent = {frame.width, frame.height};
+        if (m_specs.fmt == format::Y4M)
+            m_stream << "YUV4MPEG2 W" << frame.width << " H" << frame.height << " F" << m_specs.framerate
+                     << ":1 Ip A1:1 C420jpeg\n";
+    }
+    else if (m_stream_extent.width != frame.width || m_stream_extent.height != frame.height)
+    {
+        KIT_WARN("Dropping captured frame {0}: its extent differs from the stream's", frame.index)
+        return;
+    }
+
+    if (m_specs.fmt == format::Y4M)
+        write_y4m_frame(m_stream, frame);
+    else
+        m_stream.write((const char *)frame.pixels.data(), (std::streamsize)frame.pixels.size());
+}
+} // namespace lynx
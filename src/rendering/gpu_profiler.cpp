@@ -0,0 +1,177 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/rendering/gpu_profiler.hpp"
+
+namespace lynx
+{
+static constexpr std::uint32_t TIMESTAMP_QUERY_COUNT = 2 + 2 * gpu_profiler::MAX_SCOPES;
+static constexpr std::uint32_t NO_QUERY = UINT32_MAX;
+
+gpu_profiler::gpu_profiler(const kit::ref<const device> &dev, const bool pipeline_statistics)
+    : m_device(dev), m_pipeline_statistics(pipeline_statistics)
+{
+    const VkPhysicalDeviceProperties props = dev->properties();
+    KIT_ASSERT_ERROR(props.limits.timestampComputeAndGraphics, "The device does not support timestamp queries")
+    m_timestamp_period = props.limits.timestampPeriod;
+
+    if (m_pipeline_statistics && !dev->features().pipelineStatisticsQuery)
+    {
+        KIT_WARN("The device does not support pipeline statistics queries. Only timestamps will be gathered")
+        m_pipeline_statistics = false;
+    }
+
+    for (frame_queries &frame : m_frames)
+    {
+        VkQueryPoolCreateInfo pool_info{};
+        pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        pool_info.queryCount = TIMESTAMP_QUERY_COUNT;
+        KIT_CHECK_RETURN_VALUE(vkCreateQueryPool(dev->vulkan_device(), &pool_info, nullptr, &frame.timestamps),
+                               VK_SUCCESS, CRITICAL, "Failed to create timestamp query pool")
+        if (!m_pipeline_statistics)
+            continue;
+
+        pool_info.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        pool_info.queryCount = MAX_SCOPES;
+        pool_info.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                       VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+        KIT_CHECK_RETURN_VALUE(vkCreateQueryPool(dev->vulkan_device(), &pool_info, nullptr, &frame.statistics),
+                               VK_SUCCESS, CRITICAL, "Failed to create pipeline statistics query pool")
+    }
+}
+
+gpu_profiler::~gpu_profiler()
+{
+    for (const frame_queries &frame : m_frames)
+    {
+        vkDestroyQueryPool(m_device->vulkan_device(), frame.timestamps, nullptr);
+        if (frame.statistics)
+            vkDestroyQueryPool(m_device->vulkan_device(), frame.statistics, nullptr);
+    }
+}
+
+bool gpu_profiler::begin_frame(VkCommandBuffer command_buffer, const std::uint32_t frame_index)
+{
+    LYNX_TRACE_SCOPE("lynx::gpu_profiler::begin_frame")
+    m_frame_index = frame_index;
+    frame_queries &frame = m_frames[frame_index];
+    const bool read = frame.recorded && read_back(frame);
+
+    frame.scopes.clear();
+    frame.statistics_count = 0;
+    frame.recorded = true;
+    m_open_scopes.clear();
+    m_statistics_active = false;
+
+    vkCmdResetQueryPool(command_buffer, frame.timestamps, 0, TIMESTAMP_QUERY_COUNT);
+    if (frame.statistics)
+        vkCmdResetQueryPool(command_buffer, frame.statistics, 0, MAX_SCOPES);
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestamps, 0);
+    return read;
+}
+
+void gpu_profiler::end_frame(VkCommandBuffer command_buffer)
+{
+    KIT_ASSERT_ERROR(m_open_scopes.empty(), "All gpu scopes must be closed before ending the frame")
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_frames[m_frame_index].timestamps, 1);
+}
+
+void gpu_profiler::begin_scope(VkCommandBuffer command_buffer, const char *name)
+{
+    frame_queries &frame = m_frames[m_frame_index];
+    if (frame.scopes.size() == MAX_SCOPES)
+    {
+        m_open_scopes.push_back(NO_QUERY);
+        return;
+    }
+
+    scope_record record{name, (std::uint32_t)m_open_scopes.size(), 2 + 2 * (std::uint32_t)frame.scopes.size(),
+                        NO_QUERY};
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame.timestamps, record.timestamp_query);
+    if (frame.statistics && !m_statistics_active)
+    {
+        record.statistics_query = frame.statistics_count++;
+        vkCmdBeginQuery(command_buffer, frame.statistics, record.statistics_query, 0);
+        m_statistics_active = true;
+    }
+
+    m_open_scopes.push_back((std::uint32_t)frame.scopes.size());
+    frame.scopes.push_back(std::move(record));
+}
+
+void gpu_profiler::end_scope(VkCommandBuffer command_buffer)
+{
+    KIT_ASSERT_ERROR(!m_open_scopes.empty(), "There is no gpu scope to end")
+    const std::uint32_t index = m_open_scopes.back();
+    m_open_scopes.pop_back();
+    if (index == NO_QUERY)
+        return;
+
+    frame_queries &frame = m_frames[m_frame_index];
+    const scope_record &record = frame.scopes[index];
+    vkCmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame.timestamps,
+                        record.timestamp_query + 1);
+    if (record.statistics_query != NO_QUERY)
+    {
+        vkCmdEndQuery(command_buffer, frame.statistics, record.statistics_query);
+        m_statistics_active = false;
+    }
+}
+
+bool gpu_profiler::read_back(frame_queries &frame)
+{
+    LYNX_TRACE_SCOPE("lynx::gpu_profiler::read_back")
+    const std::uint32_t timestamp_count = 2 + 2 * (std::uint32_t)frame.scopes.size();
+    std::array<std::uint64_t, TIMESTAMP_QUERY_COUNT> timestamps;
+
+    // The frame's fence has already been waited on, so results should be available. If they are not, the previous
+    // results are kept instead of stalling
+    if (vkGetQueryPoolResults(m_device->vulkan_device(), frame.timestamps, 0, timestamp_count,
+                              timestamp_count * sizeof(std::uint64_t), timestamps.data(), sizeof(std::uint64_t),
+                              VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        return false;
+
+    std::vector<std::uint64_t> statistics(2 * frame.statistics_count, 0);
+    if (frame.statistics_count > 0 &&
+        vkGetQueryPoolResults(m_device->vulkan_device(), frame.statistics, 0, frame.statistics_count,
+                              statistics.size() * sizeof(std::uint64_t), statistics.data(),
+                              2 * sizeof(std::uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+        std::fill(statistics.begin(), statistics.end(), 0);
+
+    const auto to_milliseconds = [this](const std::uint64_t begin, const std::uint64_t end) {
+        return end > begin ? (float)((double)(end - begin) * m_timestamp_period * 1.e-6) : 0.f;
+    };
+
+    m_frame_milliseconds = to_milliseconds(timestamps[0], timestamps[1]);
+    m_timings.clear();
+    for (const scope_record &record : frame.scopes)
+    {
+        gpu_scope_timing timing{record.name,
+                                record.depth,
+                                to_milliseconds(timestamps[record.timestamp_query],
+                                                timestamps[record.timestamp_query + 1]),
+                                to_milliseconds(timestamps[0], timestamps[record.timestamp_query]),
+                                0,
+                                0};
+        if (record.statistics_query != NO_QUERY)
+        {
+            timing.vertex_invocations = statistics[2 * record.statistics_query];
+            timing.fragment_invocations = statistics[2 * record.statistics_query + 1];
+        }
+        m_timings.push_back(std::move(timing));
+    }
+    return true;
+}
+
+const std::vector<gpu_scope_timing> &gpu_profiler::timings() const
+{
+    return m_timings;
+}
+float gpu_profiler::frame_milliseconds() const
+{
+    return m_frame_milliseconds;
+}
+bool gpu_profiler::pipeline_statistics() const
+{
+    return m_pipeline_statistics;
+}
+} // namespace lynx
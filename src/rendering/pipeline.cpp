@@ -2,8 +2,6 @@
 #include "lynx/rendering/pipeline.hpp"
 #include "lynx/drawing/model.hpp"
 
-#include <fstream>
-
 namespace lynx
 {
 pipeline::pipeline(const kit::ref<const device> &dev, const config_info &config) : m_device(dev)
@@ -15,27 +13,14 @@ pipeline::pipeline(const kit::ref<const device> &dev, const config_info &config)
 
 pipeline::~pipeline()
 {
-    vkDestroyShaderModule(m_device->vulkan_device(), m_vert_shader_module, nullptr);
-    vkDestroyShaderModule(m_device->vulkan_device(), m_frag_shader_module, nullptr);
-    vkDestroyPipeline(m_device->vulkan_device(), m_graphics_pipeline, nullptr);
+    m_device->destroy_shader_module(m_vert_shader_module);
+    m_device->destroy_shader_module(m_frag_shader_module);
+    m_device->destroy_pipeline(m_graphics_pipeline);
 }
 
 void pipeline::bind(VkCommandBuffer command_buffer) const
 {
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphics_pipeline);
-}
-
-static std::vector<char> read_file(const char *path)
-{
-    std::ifstream file{path, std::ios::ate | std::ios::binary};
-    KIT_ASSERT_ERROR(file.is_open(), "File at path {0} not found", path)
-
-    const auto file_size = file.tellg();
-    std::vector<char> buffer((std::size_t)file_size);
-
-    file.seekg(0);
-    file.read(buffer.data(), file_size);
-    return buffer;
+    m_device->bind_pipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphics_pipeline);
 }
 
 void pipeline::init(const config_info &config)
@@ -43,11 +28,8 @@ void pipeline::init(const config_info &config)
     KIT_ASSERT_ERROR(config.pipeline_layout, "Pipeline layout must be provided to create graphics pipeline!")
     KIT_ASSERT_ERROR(config.render_pass, "Render pass must be provided to create graphics pipeline!")
 
-    const std::vector<char> vert_code = read_file(config.vertex_shader_path);
-    const std::vector<char> frag_code = read_file(config.fragment_shader_path);
-
-    create_shader_module(vert_code, &m_vert_shader_module);
-    create_shader_module(frag_code, &m_frag_shader_module);
+    m_vert_shader_module = m_device->create_shader_module(config.vertex_shader_path);
+    m_frag_shader_module = m_device->create_shader_module(config.fragment_shader_path);
 
     std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages;
     for (auto &shader_stage : shader_stages)
@@ -89,19 +71,7 @@ void pipeline::init(const config_info &config)
 
     pipeline_info.basePipelineIndex = -1;
     pipeline_info.basePipelineHandle = VK_NULL_HANDLE;
-    KIT_CHECK_RETURN_VALUE(vkCreateGraphicsPipelines(m_device->vulkan_device(), VK_NULL_HANDLE, 1, &pipeline_info,
-                                                     nullptr, &m_graphics_pipeline),
-                           VK_SUCCESS, CRITICAL, "Failed to create graphics pipeline")
-}
-
-void pipeline::create_shader_module(const std::vector<char> &code, VkShaderModule *shader_module) const
-{
-    VkShaderModuleCreateInfo create_info{};
-    create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    create_info.codeSize = code.size();
-    create_info.pCode = (const std::uint32_t *)code.data();
-    KIT_CHECK_RETURN_VALUE(vkCreateShaderModule(m_device->vulkan_device(), &create_info, nullptr, shader_module),
-                           VK_SUCCESS, CRITICAL, "Failed to create shader module")
+    m_graphics_pipeline = m_device->create_graphics_pipeline(pipeline_info);
 }
 
 void pipeline::config_info::default_config(config_info &config)
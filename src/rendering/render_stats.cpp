@@ -0,0 +1,134 @@
+#include "lynx/internal/pch.hpp"
+#include "lynx/rendering/render_stats.hpp"
+
+namespace lynx
+{
+void render_stats::draw(const std::uint32_t vertex_count, const std::uint32_t instance_count)
+{
+    draw_calls++;
+    instances += instance_count;
+    vertices += (std::uint64_t)vertex_count * instance_count;
+}
+void render_stats::draw_indexed(const std::uint32_t index_count, const std::uint32_t instance_count)
+{
+    draw_calls++;
+    instances += instance_count;
+    indices += (std::uint64_t)index_count * instance_count;
+}
+void render_stats::dispatch()
+{
+    dispatches++;
+}
+
+void render_stats::bind_pipeline()
+{
+    pipeline_binds++;
+}
+void render_stats::bind_vertex_buffers(const std::uint32_t count)
+{
+    vertex_buffer_binds += count;
+}
+void render_stats::bind_index_buffer()
+{
+    index_buffer_binds++;
+}
+void render_stats::push_constants(const std::uint32_t size)
+{
+    push_constant_bytes += size;
+}
+
+void render_stats::allocate(const VkDeviceSize size)
+{
+    allocations++;
+    allocated_bytes += size;
+}
+void render_stats::free()
+{
+    frees++;
+}
+
+void render_stats::reset()
+{
+    const std::uint64_t next = frame + 1;
+    *this = {};
+    frame = next;
+}
+
+render_stats_history::render_stats_history(const std::size_t capacity) : m_capacity(capacity)
+{
+    KIT_ASSERT_ERROR(capacity > 0, "Render stats history capacity must be greater than 0")
+}
+
+void render_stats_history::push(const render_stats &stats)
+{
+    if (m_frames.size() == m_capacity)
+        m_frames.pop_front();
+    m_frames.push_back(stats);
+}
+void render_stats_history::clear()
+{
+    m_frames.clear();
+}
+
+void render_stats_history::dump_csv(const std::string &path) const
+{
+    std::ofstream file{path, std::ios::trunc};
+    KIT_ASSERT_ERROR(file.is_open(), "Failed to open render stats file at {0}", path)
+
+    file << "frame,draw_calls,instances,vertices,indices,dispatches,pipeline_binds,vertex_buffer_binds,"
+            "index_buffer_binds,push_constant_bytes,allocations,frees,allocated_bytes,gpu_milliseconds,render_data\n";
+    for (const render_stats &stats : m_frames)
+    {
+        std::size_t render_data = 0;
+        for (const render_stats::system_entry &entry : stats.render_systems)
+            render_data += entry.render_data;
+        file << stats.frame << ',' << stats.draw_calls << ',' << stats.instances << ',' << stats.vertices << ','
+             << stats.indices << ',' << stats.dispatches << ',' << stats.pipeline_binds << ','
+             << stats.vertex_buffer_binds << ',' << stats.index_buffer_binds << ',' << stats.push_constant_bytes
+             << ',' << stats.allocations << ',' << stats.frees << ',' << stats.allocated_bytes << ','
+             << stats.gpu_milliseconds << ',' << render_data << '\n';
+    }
+}
+
+void render_stats_history::dump_json(const std::string &path) const
+{
+    std::ofstream file{path, std::ios::trunc};
+    KIT_ASSERT_ERROR(file.is_open(), "Failed to open render stats file at {0}", path)
+
+    file << "[\n";
+    for (std::size_t i = 0; i < m_frames.size(); i++)
+    {
+        const render_stats &stats = m_frames[i];
+        file << "  {\"frame\": " << stats.frame << ", \"draw_calls\": " << stats.draw_calls
+             << ", \"instances\": " << stats.instances << ", \"vertices\": " << stats.vertices
+             << ", \"indices\": " << stats.indices << ", \"dispatches\": " << stats.dispatches
+             << ", \"pipeline_binds\": " << stats.pipeline_binds
+             << ", \"vertex_buffer_binds\": " << stats.vertex_buffer_binds
+             << ", \"index_buffer_binds\": " << stats.index_buffer_binds
+             << ", \"push_constant_bytes\": " << stats.push_constant_bytes
+             << ", \"allocations\": " << stats.allocations << ", \"frees\": " << stats.frees
+             << ", \"allocated_bytes\": " << stats.allocated_bytes
+             << ", \"gpu_milliseconds\": " << stats.gpu_milliseconds << ", \"render_systems\": {";
+        for (std::size_t j = 0; j < stats.render_systems.size(); j++)
+            file << (j == 0 ? "" : ", ") << '"' << stats.render_systems[j].name
+                 << "\": " << stats.render_systems[j].render_data;
+        file << "}}" << (i + 1 < m_frames.size() ? ",\n" : "\n");
+    }
+    file << "]\n";
+}
+
+std::size_t render_stats_history::size() const
+{
+    return m_frames.size();
+}
+std::size_t render_stats_history::capacity() const
+{
+    return m_capacity;
+}
+
+const render_stats &render_stats_history::operator[](const std::size_t index) const
+{
+    KIT_ASSERT_ERROR(index < m_frames.size(), "Index exceeds container size: {0}", index)
+    return m_frames[index];
+}
+} // namespace lynx
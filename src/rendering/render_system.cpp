@@ -11,12 +11,26 @@
 #define VERTEX_SHADER_3D_PATH LYNX_SHADER_PATH "bin/shader3D.vert.spv"
 #define FRAGMENT_SHADER_3D_PATH LYNX_SHADER_PATH "bin/shader3D.frag.spv"
 
+#define THICK_LINE_VERTEX_SHADER_PATH LYNX_SHADER_PATH "bin/thick_line.vert.spv"
+#define THICK_LINE_FRAGMENT_SHADER_PATH LYNX_SHADER_PATH "bin/thick_line.frag.spv"
+
+#define TRAIL_VERTEX_SHADER_2D_PATH LYNX_SHADER_PATH "bin/trail2D.vert.spv"
+#define TRAIL_VERTEX_SHADER_3D_PATH LYNX_SHADER_PATH "bin/trail3D.vert.spv"
+#define TRAIL_FRAGMENT_SHADER_PATH LYNX_SHADER_PATH "bin/trail.frag.spv"
+
+#define POINT_CLOUD_VERTEX_SHADER_PATH LYNX_SHADER_PATH "bin/point_cloud.vert.spv"
+#define POINT_SPRITE_VERTEX_SHADER_PATH LYNX_SHADER_PATH "bin/point_sprite.vert.spv"
+#define POINT_CLOUD_FRAGMENT_SHADER_PATH LYNX_SHADER_PATH "bin/point_cloud.frag.spv"
+
+#define PARTICLE_VERTEX_SHADER_PATH LYNX_SHADER_PATH "bin/particle.vert.spv"
+#define PARTICLE_COMPUTE_SHADER_PATH LYNX_SHADER_PATH "bin/particle.comp.spv"
+
 namespace lynx
 {
 template <Dimension Dim> render_system<Dim>::~render_system()
 {
     if (m_device)
-        vkDestroyPipelineLayout(m_device->vulkan_device(), m_pipeline_layout, nullptr);
+        m_device->destroy_pipeline_layout(m_pipeline_layout);
 }
 
 template <Dimension Dim> void render_system<Dim>::init(const kit::ref<const device> &dev, VkRenderPass render_pass)
@@ -43,8 +57,7 @@ template <Dimension Dim> void render_system<Dim>::create_pipeline_layout(const p
     layout_info.pSetLayouts = nullptr;
     layout_info.pushConstantRangeCount = 1;
     layout_info.pPushConstantRanges = &push_constant_range;
-    KIT_CHECK_RETURN_VALUE(vkCreatePipelineLayout(m_device->vulkan_device(), &layout_info, nullptr, &m_pipeline_layout),
-                           VK_SUCCESS, CRITICAL, "Failed to create pipeline layout")
+    m_pipeline_layout = m_device->create_pipeline_layout(layout_info);
 }
 
 template <Dimension Dim>
@@ -57,21 +70,28 @@ void render_system<Dim>::create_pipeline(const VkRenderPass render_pass, pipelin
     m_pipeline = kit::make_scope<pipeline>(m_device, config);
 }
 
-template <Dimension Dim> void render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam) const
+template <Dimension Dim>
+void render_system<Dim>::dispatch(VkCommandBuffer command_buffer, const std::uint32_t frame_index) const
 {
-    if (m_render_data.empty())
+}
+
+template <Dimension Dim>
+void render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam, const VkExtent2D extent) const
+{
+    if (m_render_data[m_render_slot].empty())
         return;
 
-    KIT_PERF_SCOPE("lynx::render_system::render")
+    LYNX_TRACE_SCOPE("lynx::render_system::render")
     m_pipeline->bind(command_buffer);
     const glm::mat4 &proj = cam.projection();
-    for (const render_data &rdata : m_render_data)
+    for (const render_data &rdata : m_render_data[m_render_slot])
     {
         KIT_ASSERT_CRITICAL(m_device, "Render system must be properly initialized before rendering!")
 
         const push_constant_data push_with_camera = {rdata.mdl_transform, proj};
-        vkCmdPushConstants(command_buffer, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                           0, sizeof(push_constant_data), &push_with_camera);
+        m_device->push_constants(command_buffer, m_pipeline_layout,
+                                 VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(push_constant_data),
+                                 &push_with_camera);
 
         rdata.mdl->bind(command_buffer);
         rdata.mdl->draw(command_buffer);
@@ -84,21 +104,32 @@ typename render_system<Dim>::render_data render_system<Dim>::create_render_data(
 {
     KIT_ASSERT_CRITICAL(mdl, "Model cannot be a null pointer")
     if constexpr (std::is_same_v<Dim, dimension::two>)
-    {
-        const float z_offset = 1.f - ++s_z_offset_counter2D * std::numeric_limits<float>::epsilon();
-        mdl_transform[3][2] = z_offset;
-    }
+        mdl_transform[3][2] = next_z_offset2D();
     return {mdl, mdl_transform};
 }
 
+template <Dimension Dim> float render_system<Dim>::next_z_offset2D()
+{
+    return 1.f - ++s_z_offset_counter2D * std::numeric_limits<float>::epsilon();
+}
+
 template <Dimension Dim> void render_system<Dim>::push_render_data(const render_data &rdata)
 {
-    m_render_data.push_back(rdata);
+    m_render_data[m_record_slot].push_back(rdata);
 }
 
 template <Dimension Dim> void render_system<Dim>::clear_render_data()
 {
-    m_render_data.clear();
+    m_render_data[m_record_slot].clear();
+}
+
+template <Dimension Dim> const char *render_system<Dim>::name() const
+{
+    return "render_system";
+}
+template <Dimension Dim> std::size_t render_system<Dim>::render_data_count() const
+{
+    return m_render_data[m_render_slot].size();
 }
 
 template <Dimension Dim> void render_system<Dim>::pipeline_config(pipeline::config_info &config) const
@@ -144,34 +175,484 @@ template <Dimension Dim> void render_system<Dim>::draw(const drawable_t &drawabl
     drawable.draw(*this);
 }
 
+template <Dimension Dim> const char *point_render_system<Dim>::name() const
+{
+    return "point";
+}
 template <Dimension Dim> void point_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
 {
     render_system<Dim>::pipeline_config(config);
     config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
 }
 
+template <Dimension Dim> const char *line_render_system<Dim>::name() const
+{
+    return "line";
+}
 template <Dimension Dim> void line_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
 {
     render_system<Dim>::pipeline_config(config);
     config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
 }
 
+template <Dimension Dim> const char *line_strip_render_system<Dim>::name() const
+{
+    return "line_strip";
+}
 template <Dimension Dim> void line_strip_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
 {
     render_system<Dim>::pipeline_config(config);
     config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+    config.input_assembly_info.primitiveRestartEnable = VK_TRUE;
 }
 
+template <Dimension Dim> const char *triangle_render_system<Dim>::name() const
+{
+    return "triangle";
+}
 template <Dimension Dim> void triangle_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
 {
     render_system<Dim>::pipeline_config(config);
     config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 }
 
+template <Dimension Dim> const char *triangle_strip_render_system<Dim>::name() const
+{
+    return "triangle_strip";
+}
 template <Dimension Dim> void triangle_strip_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
 {
     render_system<Dim>::pipeline_config(config);
     config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    config.input_assembly_info.primitiveRestartEnable = VK_TRUE;
+}
+
+std::vector<VkVertexInputBindingDescription> thick_segment::binding_descriptions()
+{
+    return {{0, sizeof(thick_segment), VK_VERTEX_INPUT_RATE_INSTANCE}};
+}
+std::vector<VkVertexInputAttributeDescription> thick_segment::attribute_descriptions()
+{
+    return {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(thick_segment, p0)},
+            {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(thick_segment, p1)},
+            {2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(thick_segment, p2)},
+            {3, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(thick_segment, p3)},
+            {4, 0, VK_FORMAT_R32_SFLOAT, offsetof(thick_segment, width)},
+            {5, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(thick_segment, color)},
+            {6, 0, VK_FORMAT_R32_UINT, offsetof(thick_segment, join)}};
+}
+
+template <Dimension Dim>
+void thick_line_render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam,
+                                           const VkExtent2D extent) const
+{
+    const std::vector<thick_segment> &segments = m_segments[this->m_render_slot];
+    if (segments.empty())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::thick_line_render_system::render")
+    KIT_ASSERT_CRITICAL(this->m_device, "Render system must be properly initialized before rendering!")
+
+    // One buffer per frame in flight so that the segments of a frame still being processed by the gpu are not
+    // overwritten
+    kit::scope<buffer> &instances = m_instance_buffers[m_buffer_index];
+    m_buffer_index = (m_buffer_index + 1) % m_instance_buffers.size();
+
+    if (!instances || instances->instance_count() < segments.size())
+    {
+        std::size_t capacity = instances ? instances->instance_count() : 64;
+        while (capacity < segments.size())
+            capacity *= 2;
+        instances = kit::make_scope<buffer>(this->m_device, sizeof(thick_segment), capacity,
+                                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        instances->map();
+    }
+    instances->write(segments.data(), segments.size() * sizeof(thick_segment));
+
+    this->m_pipeline->bind(command_buffer);
+    const thick_line_push_constant_data push = {cam.projection(), {(float)extent.width, (float)extent.height}};
+    this->m_device->push_constants(command_buffer, this->m_pipeline_layout,
+                                   VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                   sizeof(thick_line_push_constant_data), &push);
+
+    this->m_device->bind_vertex_buffer(command_buffer, instances->vulkan_buffer());
+    this->m_device->draw(command_buffer, 4, (std::uint32_t)segments.size());
+}
+
+template <Dimension Dim> void thick_line_render_system<Dim>::clear_render_data()
+{
+    m_segments[this->m_record_slot].clear();
+}
+
+template <Dimension Dim> static glm::vec3 to_segment_point(const glm::vec<Dim::N, float> &point, const float z_offset)
+{
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        return glm::vec3(point, z_offset);
+    else
+        return point;
+}
+
+template <Dimension Dim>
+void thick_line_render_system<Dim>::push_segment(const vec_t &p0, const vec_t &p1, const vec_t &p2, const vec_t &p3,
+                                                 const float width, const color &color, const line_join join)
+{
+    const float z_offset = std::is_same_v<Dim, dimension::two> ? this->next_z_offset2D() : 0.f;
+    m_segments[this->m_record_slot].push_back({to_segment_point<Dim>(p0, z_offset),
+                                               to_segment_point<Dim>(p1, z_offset),
+                                               to_segment_point<Dim>(p2, z_offset),
+                                               to_segment_point<Dim>(p3, z_offset), width, color, (std::uint32_t)join});
+}
+
+template <Dimension Dim>
+void thick_line_render_system<Dim>::push_segment(const vec_t &p1, const vec_t &p2, const float width,
+                                                 const color &color, const line_join join)
+{
+    push_segment(p1, p1, p2, p2, width, color, join);
+}
+
+template <Dimension Dim>
+void thick_line_render_system<Dim>::push_strip(const vec_t *points, const std::size_t count, const float width,
+                                               const color &color, const line_join join)
+{
+    if (count < 2)
+        return;
+
+    // The whole strip shares the same depth so that the joins between its segments do not z-fight
+    const float z_offset = std::is_same_v<Dim, dimension::two> ? this->next_z_offset2D() : 0.f;
+    std::vector<thick_segment> &segments = m_segments[this->m_record_slot];
+    segments.reserve(segments.size() + count - 1);
+    for (std::size_t i = 0; i < count - 1; i++)
+    {
+        const vec_t &p0 = i > 0 ? points[i - 1] : points[i];
+        const vec_t &p3 = i + 2 < count ? points[i + 2] : points[i + 1];
+        segments.push_back({to_segment_point<Dim>(p0, z_offset), to_segment_point<Dim>(points[i], z_offset),
+                            to_segment_point<Dim>(points[i + 1], z_offset), to_segment_point<Dim>(p3, z_offset),
+                            width, color, (std::uint32_t)join});
+    }
+}
+
+template <Dimension Dim> const char *thick_line_render_system<Dim>::name() const
+{
+    return "thick_line";
+}
+template <Dimension Dim> std::size_t thick_line_render_system<Dim>::render_data_count() const
+{
+    return m_segments[this->m_render_slot].size();
+}
+template <Dimension Dim> void thick_line_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
+{
+    pipeline::config_info::default_config(config);
+    config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    config.constant_range_size = sizeof(thick_line_push_constant_data);
+    config.binding_descriptions = thick_segment::binding_descriptions();
+    config.attribute_descriptions = thick_segment::attribute_descriptions();
+
+    config.vertex_shader_path = THICK_LINE_VERTEX_SHADER_PATH;
+    config.fragment_shader_path = THICK_LINE_FRAGMENT_SHADER_PATH;
+}
+
+template <Dimension Dim>
+void trail_render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam, const VkExtent2D extent) const
+{
+    if (m_trail_data[this->m_render_slot].empty())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::trail_render_system::render")
+    KIT_ASSERT_CRITICAL(this->m_device, "Render system must be properly initialized before rendering!")
+
+    this->m_pipeline->bind(command_buffer);
+    const glm::mat4 &proj = cam.projection();
+    for (const trail_data &tdata : m_trail_data[this->m_render_slot])
+    {
+        if (tdata.count < 2)
+            continue;
+
+        const std::uint32_t capacity = (std::uint32_t)tdata.mdl->vertex_count() - 1;
+        const trail_push_constant_data push = {proj * tdata.mdl_transform, tdata.start, tdata.count, capacity,
+                                               tdata.fade ? 1u : 0u};
+        this->m_device->push_constants(command_buffer, this->m_pipeline_layout,
+                                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                       sizeof(trail_push_constant_data), &push);
+        tdata.mdl->bind(command_buffer);
+
+        if (tdata.start + tdata.count <= capacity)
+        {
+            this->m_device->draw(command_buffer, tdata.count, 1, tdata.start);
+            continue;
+        }
+
+        // The first draw includes the mirrored vertex at index capacity, so the strip continues seamlessly into the
+        // second one
+        this->m_device->draw(command_buffer, capacity - tdata.start + 1, 1, tdata.start);
+        const std::uint32_t wrapped = tdata.start + tdata.count - capacity;
+        if (wrapped > 1)
+            this->m_device->draw(command_buffer, wrapped, 1);
+    }
+}
+
+template <Dimension Dim> void trail_render_system<Dim>::clear_render_data()
+{
+    m_trail_data[this->m_record_slot].clear();
+}
+
+template <Dimension Dim>
+void trail_render_system<Dim>::push_trail_data(const kit::ref<const model_t> &mdl, glm::mat4 transform,
+                                               const std::uint32_t start, const std::uint32_t count, const bool fade)
+{
+    KIT_ASSERT_CRITICAL(mdl, "Model cannot be a null pointer")
+    KIT_ASSERT_ERROR(mdl->vertex_count() > 1, "Trail models must hold at least two vertices")
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        transform[3][2] = this->next_z_offset2D();
+    m_trail_data[this->m_record_slot].push_back({mdl, transform, start, count, fade});
+}
+
+template <Dimension Dim> const char *trail_render_system<Dim>::name() const
+{
+    return "trail";
+}
+template <Dimension Dim> std::size_t trail_render_system<Dim>::render_data_count() const
+{
+    return m_trail_data[this->m_render_slot].size();
+}
+template <Dimension Dim> void trail_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
+{
+    render_system<Dim>::pipeline_config(config);
+    config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_LINE_STRIP;
+    config.constant_range_size = sizeof(trail_push_constant_data);
+    config.fragment_shader_path = TRAIL_FRAGMENT_SHADER_PATH;
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        config.vertex_shader_path = TRAIL_VERTEX_SHADER_2D_PATH;
+    else
+        config.vertex_shader_path = TRAIL_VERTEX_SHADER_3D_PATH;
+}
+
+template <Dimension Dim>
+void point_cloud_render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam,
+                                            const VkExtent2D extent) const
+{
+    if (m_cloud_data[this->m_render_slot].empty())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::point_cloud_render_system::render")
+    KIT_ASSERT_CRITICAL(this->m_device, "Render system must be properly initialized before rendering!")
+
+    const bool use_sprites = sprites();
+    this->m_pipeline->bind(command_buffer);
+    const glm::mat4 &proj = cam.projection();
+    for (const cloud_data &cdata : m_cloud_data[this->m_render_slot])
+    {
+        if (cdata.count == 0)
+            continue;
+
+        const point_cloud_push_constant_data push = {proj * cdata.mdl_transform,
+                                                     {(float)extent.width, (float)extent.height},
+                                                     use_sprites ? 1u : 0u,
+                                                     cdata.round ? 1u : 0u};
+        this->m_device->push_constants(command_buffer, this->m_pipeline_layout,
+                                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                       sizeof(point_cloud_push_constant_data), &push);
+
+        this->m_device->bind_vertex_buffer(command_buffer, cdata.points->vulkan_buffer());
+
+        if (use_sprites)
+            this->m_device->draw(command_buffer, 4, cdata.count);
+        else
+            this->m_device->draw(command_buffer, cdata.count);
+    }
+}
+
+template <Dimension Dim> void point_cloud_render_system<Dim>::clear_render_data()
+{
+    m_cloud_data[this->m_record_slot].clear();
+}
+
+template <Dimension Dim>
+void point_cloud_render_system<Dim>::push_cloud_data(const kit::ref<const point_buffer_t> &points, glm::mat4 transform,
+                                                     const std::uint32_t count, const bool round)
+{
+    KIT_ASSERT_CRITICAL(points, "Point buffer cannot be a null pointer")
+    KIT_ASSERT_ERROR(count <= points->size(), "Point count exceeds buffer size! Count: {0}, size: {1}", count,
+                     points->size())
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        transform[3][2] = this->next_z_offset2D();
+    m_cloud_data[this->m_record_slot].push_back({points, transform, count, round});
+}
+
+template <Dimension Dim> bool point_cloud_render_system<Dim>::sprites() const
+{
+    KIT_ASSERT_CRITICAL(this->m_device, "Render system must be properly initialized to query sprite support")
+    return !this->m_device->features().largePoints ||
+           this->m_device->properties().limits.pointSizeRange[1] < MIN_POINT_SIZE_RANGE;
+}
+
+template <Dimension Dim> const char *point_cloud_render_system<Dim>::name() const
+{
+    return "point_cloud";
+}
+template <Dimension Dim> std::size_t point_cloud_render_system<Dim>::render_data_count() const
+{
+    return m_cloud_data[this->m_render_slot].size();
+}
+template <Dimension Dim> void point_cloud_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
+{
+    pipeline::config_info::default_config(config);
+    config.constant_range_size = sizeof(point_cloud_push_constant_data);
+    config.attribute_descriptions = point_t::attribute_descriptions();
+    config.fragment_shader_path = POINT_CLOUD_FRAGMENT_SHADER_PATH;
+    if (sprites())
+    {
+        config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+        config.binding_descriptions = point_t::binding_descriptions(VK_VERTEX_INPUT_RATE_INSTANCE);
+        config.vertex_shader_path = POINT_SPRITE_VERTEX_SHADER_PATH;
+    }
+    else
+    {
+        config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        config.binding_descriptions = point_t::binding_descriptions(VK_VERTEX_INPUT_RATE_VERTEX);
+        config.vertex_shader_path = POINT_CLOUD_VERTEX_SHADER_PATH;
+    }
+}
+
+std::vector<VkVertexInputBindingDescription> gpu_particle::binding_descriptions()
+{
+    return {{0, sizeof(gpu_particle), VK_VERTEX_INPUT_RATE_INSTANCE}};
+}
+std::vector<VkVertexInputAttributeDescription> gpu_particle::attribute_descriptions()
+{
+    return {{0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(gpu_particle, position)},
+            {1, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(gpu_particle, velocity)},
+            {2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(gpu_particle, color)}};
+}
+
+template <Dimension Dim>
+void particle_render_system<Dim>::init(const kit::ref<const device> &dev, const VkRenderPass render_pass)
+{
+    render_system<Dim>::init(dev, render_pass);
+
+    compute_pipeline::config_info config{};
+    config.compute_shader_path = PARTICLE_COMPUTE_SHADER_PATH;
+    config.storage_buffer_count = 1;
+    config.constant_range_size = sizeof(particle_compute_push_constant_data);
+    m_compute_pipeline = kit::make_scope<compute_pipeline>(dev, config);
+}
+
+template <Dimension Dim>
+void particle_render_system<Dim>::dispatch(VkCommandBuffer command_buffer, const std::uint32_t frame_index) const
+{
+    if (m_particle_data[this->m_render_slot].empty())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::particle_render_system::dispatch")
+    KIT_ASSERT_CRITICAL(m_compute_pipeline, "Render system must be properly initialized before dispatching!")
+
+    // The previous frame may still be reading the particles as vertex input (write after read), and its compute writes
+    // must be visible to this frame's integration (write after write, read after write)
+    VkMemoryBarrier previous{};
+    previous.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    previous.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    previous.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    this->m_device->pipeline_barrier(command_buffer,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+                                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, &previous);
+
+    // Descriptor sets of this frame index were last used by a frame whose fence has already been waited on, so they
+    // can be safely rewritten
+    std::vector<VkDescriptorSet> &sets = m_descriptor_sets[frame_index];
+    m_compute_pipeline->bind(command_buffer);
+
+    std::size_t set_index = 0;
+    for (const particle_data &pdata : m_particle_data[this->m_render_slot])
+    {
+        if (pdata.count == 0)
+            continue;
+        // The elapsed time is only consumed once its integration is recorded, so skipped or overwritten frames keep it
+        const float dt = pdata.pending_dt->exchange(0.f, std::memory_order_relaxed);
+        if (dt == 0.f)
+            continue;
+        if (set_index == sets.size())
+            sets.push_back(m_compute_pipeline->allocate_descriptor_set());
+
+        const VkDescriptorSet set = sets[set_index++];
+        m_compute_pipeline->write_descriptor_set(set, {pdata.particles.get()});
+        m_compute_pipeline->bind_descriptor_set(command_buffer, set);
+
+        const particle_compute_push_constant_data push = {pdata.gravity, dt, pdata.damping, pdata.count};
+        m_compute_pipeline->push_constants(command_buffer, &push, sizeof(particle_compute_push_constant_data));
+        m_compute_pipeline->dispatch(command_buffer, (pdata.count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE);
+    }
+
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    this->m_device->pipeline_barrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                     VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, &barrier);
+}
+
+template <Dimension Dim>
+void particle_render_system<Dim>::render(VkCommandBuffer command_buffer, const camera_t &cam,
+                                         const VkExtent2D extent) const
+{
+    if (m_particle_data[this->m_render_slot].empty())
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::particle_render_system::render")
+    this->m_pipeline->bind(command_buffer);
+    const glm::mat4 &proj = cam.projection();
+    for (const particle_data &pdata : m_particle_data[this->m_render_slot])
+    {
+        if (pdata.count == 0)
+            continue;
+
+        const point_cloud_push_constant_data push = {
+            proj * pdata.mdl_transform, {(float)extent.width, (float)extent.height}, 1u, pdata.round ? 1u : 0u};
+        this->m_device->push_constants(command_buffer, this->m_pipeline_layout,
+                                       VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                       sizeof(point_cloud_push_constant_data), &push);
+
+        this->m_device->bind_vertex_buffer(command_buffer, pdata.particles->vulkan_buffer());
+        this->m_device->draw(command_buffer, 4, pdata.count);
+    }
+}
+
+template <Dimension Dim> void particle_render_system<Dim>::clear_render_data()
+{
+    m_particle_data[this->m_record_slot].clear();
+}
+
+template <Dimension Dim>
+void particle_render_system<Dim>::push_particle_data(const kit::ref<const buffer> &particles, glm::mat4 transform,
+                                                     const std::uint32_t count,
+                                                     const kit::ref<std::atomic<float>> &pending_dt,
+                                                     const glm::vec4 &gravity, const float damping, const bool round)
+{
+    KIT_ASSERT_CRITICAL(particles, "Particle buffer cannot be a null pointer")
+    KIT_ASSERT_ERROR(count <= particles->instance_count(), "Particle count exceeds buffer size! Count: {0}, size: {1}",
+                     count, particles->instance_count())
+    if constexpr (std::is_same_v<Dim, dimension::two>)
+        transform[3][2] = this->next_z_offset2D();
+    m_particle_data[this->m_record_slot].push_back({particles, transform, count, pending_dt, gravity, damping, round});
+}
+
+template <Dimension Dim> const char *particle_render_system<Dim>::name() const
+{
+    return "particle";
+}
+template <Dimension Dim> std::size_t particle_render_system<Dim>::render_data_count() const
+{
+    return m_particle_data[this->m_render_slot].size();
+}
+template <Dimension Dim> void particle_render_system<Dim>::pipeline_config(pipeline::config_info &config) const
+{
+    pipeline::config_info::default_config(config);
+    config.input_assembly_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    config.constant_range_size = sizeof(point_cloud_push_constant_data);
+    config.binding_descriptions = gpu_particle::binding_descriptions();
+    config.attribute_descriptions = gpu_particle::attribute_descriptions();
+
+    config.vertex_shader_path = PARTICLE_VERTEX_SHADER_PATH;
+    config.fragment_shader_path = POINT_CLOUD_FRAGMENT_SHADER_PATH;
 }
 
 template class render_system<dimension::two>;
@@ -191,4 +672,16 @@ template class triangle_render_system<dimension::three>;
 
 template class triangle_strip_render_system<dimension::two>;
 template class triangle_strip_render_system<dimension::three>;
+
+template class thick_line_render_system<dimension::two>;
+template class thick_line_render_system<dimension::three>;
+
+template class trail_render_system<dimension::two>;
+template class trail_render_system<dimension::three>;
+
+template class point_cloud_render_system<dimension::two>;
+template class point_cloud_render_system<dimension::three>;
+
+template class particle_render_system<dimension::two>;
+template class particle_render_system<dimension::three>;
 } // namespace lynx
\ No newline at end of file
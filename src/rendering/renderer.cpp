@@ -5,17 +5,125 @@
 namespace lynx
 {
 template <Dimension Dim>
-renderer<Dim>::renderer(const kit::ref<const device> &dev, window_t &win) : m_window(win), m_device(dev)
+renderer<Dim>::renderer(const kit::ref<const device> &dev, window_t &win, const lynx::swap_chain::config_info &config)
+    : m_window(win), m_device(dev)
 {
-    create_swap_chain();
-    create_command_buffers();
+    KIT_CHECK_RETURN_VALUE(create_swap_chain(config), true, CRITICAL, "The window must not start minimized")
+    create_command_buffers(config.frames_in_flight);
 }
 
 template <Dimension Dim> renderer<Dim>::~renderer()
 {
+    if (m_capture)
+        m_capture->read_all();
     free_command_buffers();
 }
 
+template <Dimension Dim> void renderer<Dim>::start_capture(const frame_capture::specs &spc)
+{
+    KIT_ASSERT_ERROR(!m_capture, "A capture is already in progress")
+    KIT_ASSERT_ERROR(m_swap_chain->capturable(), "The swap chain images do not support being captured")
+    m_capture = kit::make_scope<frame_capture>(m_device, spc);
+}
+template <Dimension Dim> void renderer<Dim>::start_capture(frame_capture::callback on_frame)
+{
+    KIT_ASSERT_ERROR(!m_capture, "A capture is already in progress")
+    KIT_ASSERT_ERROR(m_swap_chain->capturable(), "The swap chain images do not support being captured")
+    m_capture = kit::make_scope<frame_capture>(m_device, std::move(on_frame));
+}
+template <Dimension Dim> void renderer<Dim>::stop_capture()
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot stop a capture while a frame is in progress")
+    if (!m_capture)
+        return;
+    m_capture->read_all();
+    m_capture.reset();
+}
+template <Dimension Dim> bool renderer<Dim>::capturing() const
+{
+    return (bool)m_capture;
+}
+
+template <Dimension Dim> void renderer<Dim>::enable_gpu_profiling(const bool pipeline_statistics)
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot enable gpu profiling while a frame is in progress")
+    KIT_ASSERT_ERROR(!m_device->null_backend(), "Gpu profiling is not available with the null backend")
+    m_device->wait_idle();
+    m_gpu_profiler = kit::make_scope<lynx::gpu_profiler>(m_device, pipeline_statistics);
+}
+template <Dimension Dim> void renderer<Dim>::disable_gpu_profiling()
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot disable gpu profiling while a frame is in progress")
+    KIT_ASSERT_ERROR(!m_dynamic_resolution, "Cannot disable gpu profiling while dynamic resolution is fed from it")
+    m_device->wait_idle();
+    m_gpu_profiler.reset();
+}
+template <Dimension Dim> const gpu_profiler *renderer<Dim>::gpu_profiler() const
+{
+    return m_gpu_profiler.get();
+}
+
+template <Dimension Dim> void renderer<Dim>::enable_dynamic_resolution(const lynx::dynamic_resolution::specs &spc)
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot enable dynamic resolution while a frame is in progress")
+    KIT_ASSERT_ERROR(m_swap_chain->upscalable(), "The swap chain images do not support being upscaled into")
+    if (!m_gpu_profiler)
+        enable_gpu_profiling();
+    m_dynamic_resolution = kit::make_scope<lynx::dynamic_resolution>(m_device, *m_swap_chain, spc);
+}
+template <Dimension Dim> void renderer<Dim>::disable_dynamic_resolution()
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot disable dynamic resolution while a frame is in progress")
+    m_device->wait_idle();
+    m_dynamic_resolution.reset();
+}
+template <Dimension Dim> const dynamic_resolution *renderer<Dim>::dynamic_resolution() const
+{
+    return m_dynamic_resolution.get();
+}
+template <Dimension Dim> dynamic_resolution *renderer<Dim>::dynamic_resolution()
+{
+    return m_dynamic_resolution.get();
+}
+
+template <Dimension Dim> void renderer<Dim>::begin_gpu_scope(VkCommandBuffer command_buffer, const char *name)
+{
+    if (m_gpu_profiler)
+        m_gpu_profiler->begin_scope(command_buffer, name);
+}
+template <Dimension Dim> void renderer<Dim>::end_gpu_scope(VkCommandBuffer command_buffer)
+{
+    if (m_gpu_profiler)
+        m_gpu_profiler->end_scope(command_buffer);
+}
+
+template <Dimension Dim> void renderer<Dim>::reconfigure(const lynx::swap_chain::config_info &config)
+{
+    KIT_ASSERT_ERROR(!m_frame_started, "Cannot reconfigure the swap chain while a frame is in progress")
+    KIT_ASSERT_ERROR(config.frames_in_flight > 0 && config.frames_in_flight <= swap_chain::MAX_FRAMES_IN_FLIGHT,
+                     "Frames in flight must be between 1 and MAX_FRAMES_IN_FLIGHT")
+    if (config.frames_in_flight == m_command_buffers.size())
+    {
+        create_swap_chain(config);
+        return;
+    }
+
+    // The frame slots change, so nothing submitted with the old ones may still be running. Pending captures are indexed
+    // by frame, and must be read before the frame indices restart
+    if (m_capture)
+        m_capture->read_all();
+    m_device->wait_idle();
+    create_swap_chain(config);
+    free_command_buffers();
+    create_command_buffers(config.frames_in_flight);
+    m_submit_times.fill(0);
+    m_frame_index = 0;
+}
+template <Dimension Dim> std::uint32_t renderer<Dim>::frames_in_flight() const
+{
+    return (std::uint32_t)m_command_buffers.size();
+}
+
 template <Dimension Dim> bool renderer<Dim>::frame_in_progress() const
 {
     return m_frame_started;
@@ -37,81 +145,105 @@ template <Dimension Dim> const swap_chain &renderer<Dim>::swap_chain() const
     return *m_swap_chain;
 }
 
-template <Dimension Dim> void renderer<Dim>::create_swap_chain()
+// This may run on the render thread, so a minimized window leaves the swap chain stale instead of waiting for events
+template <Dimension Dim> bool renderer<Dim>::create_swap_chain(const lynx::swap_chain::config_info &config)
 {
-    VkExtent2D ext = m_window.extent();
-    while (ext.width == 0 || ext.height == 0)
+    m_config = config;
+    const VkExtent2D ext = m_window.extent();
+    if (!m_device->headless() && (ext.width == 0 || ext.height == 0))
     {
-        ext = m_window.extent();
-        glfwWaitEvents();
+        m_swap_chain_stale = true;
+        return false;
     }
 
-    vkDeviceWaitIdle(m_device->vulkan_device());
-    m_swap_chain = kit::make_scope<lynx::swap_chain>(m_device, ext, std::move(m_swap_chain));
+    // The offscreen target is not retired asynchronously like the swap chain, so it may only be rebuilt once idle
+    if (m_dynamic_resolution)
+        m_device->wait_idle();
+    m_swap_chain = kit::make_scope<lynx::swap_chain>(m_device, ext, config, std::move(m_swap_chain));
+    m_swap_chain_stale = false;
+    if (m_dynamic_resolution)
+        m_dynamic_resolution->resize(*m_swap_chain);
     // create_pipeline(); // If render passes are not compatible
+    return true;
 }
 
-template <Dimension Dim> void renderer<Dim>::create_command_buffers()
+template <Dimension Dim> void renderer<Dim>::create_command_buffers(const std::uint32_t count)
 {
-    VkCommandBufferAllocateInfo alloc_info{};
-    alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    alloc_info.commandPool = m_device->command_pool();
-    alloc_info.commandBufferCount = (std::uint32_t)m_command_buffers.size();
-
-    KIT_CHECK_RETURN_VALUE(vkAllocateCommandBuffers(m_device->vulkan_device(), &alloc_info, m_command_buffers.data()),
-                           VK_SUCCESS, CRITICAL, "Failed to create command buffers")
+    m_command_buffers.resize(count);
+    m_device->allocate_command_buffers(m_command_buffers.data(), count);
 }
 
 template <Dimension Dim> void renderer<Dim>::free_command_buffers()
 {
-    vkFreeCommandBuffers(m_device->vulkan_device(), m_device->command_pool(), (std::uint32_t)m_command_buffers.size(),
-                         m_command_buffers.data());
+    m_device->free_command_buffers(m_command_buffers.data(), (std::uint32_t)m_command_buffers.size());
 }
 
 template <Dimension Dim> VkCommandBuffer renderer<Dim>::begin_frame()
 {
-    KIT_PERF_SCOPE("lynx::renderer::begin_frame")
+    LYNX_TRACE_SCOPE("lynx::renderer::begin_frame")
     KIT_ASSERT_ERROR(!m_frame_started, "Cannot begin a new frame when there is already one in progress")
 
+    // However many resize events arrived since the last frame, the swap chain is rebuilt once with the latest extent
+    if (m_window.was_resized())
+    {
+        m_swap_chain_stale = true;
+        m_window.complete_resize();
+    }
+    if (m_swap_chain_stale && !create_swap_chain(m_config))
+        return nullptr;
+
     const VkResult result = m_swap_chain->acquire_next_image(&m_image_index);
+
+    // The frame's fence has been waited on, so its previous capture is ready to be read
+    if (m_capture)
+        m_capture->read(m_frame_index);
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
-        create_swap_chain();
+        m_swap_chain_stale = true;
         return nullptr;
     }
 
     KIT_ASSERT_CRITICAL(result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR, "Failed to acquire swap chain image")
     m_frame_started = true;
-    VkCommandBufferBeginInfo begin_info{};
-    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-
-    KIT_CHECK_RETURN_VALUE(vkResetCommandBuffer(m_command_buffers[m_frame_index], 0), VK_SUCCESS, CRITICAL,
-                           "Failed to reset command buffer")
-    KIT_CHECK_RETURN_VALUE(vkBeginCommandBuffer(m_command_buffers[m_frame_index], &begin_info), VK_SUCCESS, CRITICAL,
-                           "Failed to begin command buffer")
+    m_device->begin_command_buffer(m_command_buffers[m_frame_index]);
+    if (m_gpu_profiler)
+    {
+        // The results just read back belong to the last frame submitted with this index. If none could be read, the
+        // profiler still holds an older frame's, which must not be fed again
+        const bool read = m_gpu_profiler->begin_frame(m_command_buffers[m_frame_index], m_frame_index);
+        if (read && m_submit_times[m_frame_index] != 0)
+            trace::record_gpu(m_submit_times[m_frame_index], m_gpu_profiler->timings(),
+                              m_gpu_profiler->frame_milliseconds());
+        m_submit_times[m_frame_index] = 0;
+        if (read && m_dynamic_resolution)
+            m_dynamic_resolution->update(m_gpu_profiler->frame_milliseconds(), m_scale_generations[m_frame_index]);
+        m_scale_generations[m_frame_index] = m_dynamic_resolution ? m_dynamic_resolution->generation() : 0;
+    }
     return m_command_buffers[m_frame_index];
 }
 template <Dimension Dim> void renderer<Dim>::end_frame()
 {
-    KIT_PERF_SCOPE("lynx::renderer::end_frame")
+    LYNX_TRACE_SCOPE("lynx::renderer::end_frame")
     KIT_ASSERT_ERROR(m_frame_started, "Cannot end a frame when there is no frame in progress")
-    KIT_CHECK_RETURN_VALUE(vkEndCommandBuffer(m_command_buffers[m_frame_index]), VK_SUCCESS, CRITICAL,
-                           "Failed to end command buffer")
+    if (m_gpu_profiler)
+        m_gpu_profiler->end_frame(m_command_buffers[m_frame_index]);
+    if (m_capture)
+        m_capture->record(m_command_buffers[m_frame_index], m_swap_chain->image(m_image_index),
+                          m_swap_chain->swap_chain_image_format(), m_swap_chain->extent(),
+                          m_device->headless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                          m_frame_index);
+    m_device->end_command_buffer(m_command_buffers[m_frame_index]);
 
+    if (m_gpu_profiler && trace::recording())
+        m_submit_times[m_frame_index] = trace::now();
     const VkResult result = m_swap_chain->submit_command_buffers(&m_command_buffers[m_frame_index], &m_image_index);
 
-    const bool recreate_fixes_issue =
-        result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_window.was_resized();
-    if (recreate_fixes_issue)
-    {
-        create_swap_chain();
-        m_window.complete_resize();
-    }
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+        m_swap_chain_stale = true;
 
-    KIT_ASSERT_CRITICAL(recreate_fixes_issue || result == VK_SUCCESS, "Failed to submit command buffers")
+    KIT_ASSERT_CRITICAL(m_swap_chain_stale || result == VK_SUCCESS, "Failed to submit command buffers")
     m_frame_started = false;
-    m_frame_index = (m_frame_index + 1) % swap_chain::MAX_FRAMES_IN_FLIGHT;
+    m_frame_index = (m_frame_index + 1) % (std::uint32_t)m_command_buffers.size();
 }
 
 template <Dimension Dim>
@@ -120,47 +252,74 @@ void renderer<Dim>::begin_swap_chain_render_pass(VkCommandBuffer command_buffer,
     KIT_ASSERT_ERROR(m_frame_started, "Cannot begin render pass if a frame is not in progress")
     KIT_ASSERT_ERROR(m_command_buffers[m_frame_index] == command_buffer,
                      "Cannot begin render pass with a command buffer from another frame")
-    KIT_PERF_SCOPE("lynx::renderer::begin_swap_chain_render_pass")
+    LYNX_TRACE_SCOPE("lynx::renderer::begin_swap_chain_render_pass")
+    const VkClearColorValue clear = {{clear_color.rgba.r, clear_color.rgba.g, clear_color.rgba.b, clear_color.rgba.a}};
+    if (m_dynamic_resolution)
+        begin_render_pass(m_dynamic_resolution->render_pass(), m_dynamic_resolution->frame_buffer(),
+                          m_dynamic_resolution->scaled_extent(), clear);
+    else
+        begin_render_pass(m_swap_chain->render_pass(), m_swap_chain->frame_buffer(m_image_index),
+                          m_swap_chain->extent(), clear);
+}
 
+template <Dimension Dim> void renderer<Dim>::composite_scene(VkCommandBuffer command_buffer)
+{
+    KIT_ASSERT_ERROR(m_frame_started, "Cannot composite the scene if a frame is not in progress")
+    KIT_ASSERT_ERROR(m_command_buffers[m_frame_index] == command_buffer,
+                     "Cannot composite the scene with a command buffer from another frame")
+    if (!m_dynamic_resolution)
+        return;
+
+    LYNX_TRACE_SCOPE("lynx::renderer::composite_scene")
+    m_device->end_render_pass(command_buffer);
+    m_dynamic_resolution->upscale(command_buffer, m_swap_chain->image(m_image_index));
+    begin_render_pass(m_dynamic_resolution->composite_render_pass(),
+                      m_dynamic_resolution->composite_frame_buffer(m_image_index), m_swap_chain->extent(), {});
+}
+
+template <Dimension Dim>
+void renderer<Dim>::begin_render_pass(const VkRenderPass render_pass, const VkFramebuffer frame_buffer,
+                                      const VkExtent2D extent, const VkClearColorValue &clear_color)
+{
     VkRenderPassBeginInfo pass_info{};
     pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    pass_info.renderPass = m_swap_chain->render_pass();
-    pass_info.framebuffer = m_swap_chain->frame_buffer(m_image_index);
+    pass_info.renderPass = render_pass;
+    pass_info.framebuffer = frame_buffer;
     pass_info.renderArea.offset = {0, 0};
-    pass_info.renderArea.extent = m_swap_chain->extent();
+    pass_info.renderArea.extent = extent;
 
     std::array<VkClearValue, 2> clear_values;
-    clear_values[0].color = {{clear_color.rgba.r, clear_color.rgba.g, clear_color.rgba.b, clear_color.rgba.a}};
+    clear_values[0].color = clear_color;
     clear_values[1].depthStencil = {1, 0};
 
     pass_info.clearValueCount = 2;
     pass_info.pClearValues = clear_values.data();
 
-    vkCmdBeginRenderPass(m_command_buffers[m_frame_index], &pass_info, VK_SUBPASS_CONTENTS_INLINE);
+    m_device->begin_render_pass(m_command_buffers[m_frame_index], pass_info);
 
     VkViewport viewport;
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = (float)m_swap_chain->width();
-    viewport.height = (float)m_swap_chain->height();
+    viewport.width = (float)extent.width;
+    viewport.height = (float)extent.height;
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
 
     VkRect2D scissor;
     scissor.offset = {0, 0};
-    scissor.extent = {m_swap_chain->width(), m_swap_chain->height()};
+    scissor.extent = extent;
 
-    vkCmdSetViewport(m_command_buffers[m_frame_index], 0, 1, &viewport);
-    vkCmdSetScissor(m_command_buffers[m_frame_index], 0, 1, &scissor);
+    m_device->set_viewport(m_command_buffers[m_frame_index], viewport);
+    m_device->set_scissor(m_command_buffers[m_frame_index], scissor);
 }
+
 template <Dimension Dim> void renderer<Dim>::end_swap_chain_render_pass(VkCommandBuffer command_buffer)
 {
     KIT_ASSERT_ERROR(m_frame_started, "Cannot end render pass if a frame is not in progress")
     KIT_ASSERT_ERROR(m_command_buffers[m_frame_index] == command_buffer,
                      "Cannot end render pass with a command buffer from another frame")
-    KIT_PERF_SCOPE("lynx::renderer::end_swap_chain_render_pass")
-
-    vkCmdEndRenderPass(m_command_buffers[m_frame_index]);
+    LYNX_TRACE_SCOPE("lynx::renderer::end_swap_chain_render_pass")
+    m_device->end_render_pass(m_command_buffers[m_frame_index]);
 }
 
 template class renderer<dimension::two>;
@@ -4,23 +4,37 @@
 namespace lynx
 {
 
-swap_chain::swap_chain(const kit::ref<const device> &dev, VkExtent2D extent, kit::scope<swap_chain> old_swap_chain)
-    : m_device(dev), m_old_swap_chain(std::move(old_swap_chain)), m_window_extent(extent)
+swap_chain::swap_chain(const kit::ref<const device> &dev, VkExtent2D extent, const config_info &config,
+                       kit::scope<swap_chain> old_swap_chain)
+    : m_device(dev), m_old_swap_chain(std::move(old_swap_chain)), m_window_extent(extent), m_config(config)
 {
+    KIT_ASSERT_ERROR(config.frames_in_flight > 0 && config.frames_in_flight <= MAX_FRAMES_IN_FLIGHT,
+                     "Frames in flight must be between 1 and MAX_FRAMES_IN_FLIGHT")
     KIT_ASSERT_ERROR(!old_swap_chain || compare_swap_formats(*old_swap_chain),
                      "Swap chain image (or depth) has changed")
 
+    if (m_device->null_backend())
+    {
+        init_null_backend();
+        m_old_swap_chain = nullptr;
+        return;
+    }
     init();
     create_image_views();
     create_render_pass();
     create_depth_resources();
     create_frame_buffers();
     create_sync_objects();
-    m_old_swap_chain = nullptr;
+
+    // Keeps the frame slots aligned with the renderer's, which keeps counting from where the old swap chain was
+    if (m_old_swap_chain && m_old_swap_chain->m_config.frames_in_flight == m_config.frames_in_flight)
+        m_current_frame = m_old_swap_chain->m_current_frame;
 }
 
 swap_chain::~swap_chain()
 {
+    if (m_device->null_backend())
+        return;
     for (VkImageView image_view : m_swap_chain_image_views)
         vkDestroyImageView(m_device->vulkan_device(), image_view, nullptr);
     m_swap_chain_image_views.clear();
@@ -31,11 +45,17 @@ swap_chain::~swap_chain()
         m_swap_chain = nullptr;
     }
 
-    for (std::size_t i = 0; i < m_depth_images.size(); i++)
+    for (std::size_t i = 0; i < m_offscreen_image_memories.size(); i++)
     {
-        vkDestroyImageView(m_device->vulkan_device(), m_depth_image_views[i], nullptr);
-        vkDestroyImage(m_device->vulkan_device(), m_depth_images[i], nullptr);
-        vkFreeMemory(m_device->vulkan_device(), m_depth_image_memories[i], nullptr);
+        vkDestroyImage(m_device->vulkan_device(), m_swap_chain_images[i], nullptr);
+        m_device->free_memory(m_offscreen_image_memories[i]);
+    }
+
+    if (m_depth_image)
+    {
+        vkDestroyImageView(m_device->vulkan_device(), m_depth_image_view, nullptr);
+        vkDestroyImage(m_device->vulkan_device(), m_depth_image, nullptr);
+        m_device->free_memory(m_depth_image_memory);
     }
 
     for (auto frame_buffer : m_swap_chain_frame_buffers)
@@ -44,7 +64,7 @@ swap_chain::~swap_chain()
     vkDestroyRenderPass(m_device->vulkan_device(), m_render_pass, nullptr);
 
     // cleanup synchronization objects
-    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (std::size_t i = 0; i < m_in_flight_fences.size(); i++)
     {
         vkDestroySemaphore(m_device->vulkan_device(), m_render_finished_semaphores[i], nullptr);
         vkDestroySemaphore(m_device->vulkan_device(), m_image_available_semaphores[i], nullptr);
@@ -52,12 +72,26 @@ swap_chain::~swap_chain()
     }
 }
 
-VkResult swap_chain::acquire_next_image(std::uint32_t *image_index) const
+VkResult swap_chain::acquire_next_image(std::uint32_t *image_index)
 {
-    KIT_PERF_SCOPE("lynx::swap_chain::acquire_next_image")
+    LYNX_TRACE_SCOPE("lynx::swap_chain::acquire_next_image")
+    if (m_device->null_backend())
+    {
+        *image_index = (std::uint32_t)m_current_frame;
+        return VK_SUCCESS;
+    }
+    if (m_old_swap_chain)
+        retire_old_swap_chain();
     vkWaitForFences(m_device->vulkan_device(), 1, &m_in_flight_fences[m_current_frame], VK_TRUE,
                     std::numeric_limits<uint64_t>::max());
 
+    // Offscreen images are paired with frames in flight, so the image is free once the frame's fence has signaled
+    if (m_device->headless())
+    {
+        *image_index = (std::uint32_t)m_current_frame;
+        return VK_SUCCESS;
+    }
+
     VkResult result =
         vkAcquireNextImageKHR(m_device->vulkan_device(), m_swap_chain, std::numeric_limits<uint64_t>::max(),
                               m_image_available_semaphores[m_current_frame], VK_NULL_HANDLE, image_index);
@@ -67,7 +101,12 @@ VkResult swap_chain::acquire_next_image(std::uint32_t *image_index) const
 
 VkResult swap_chain::submit_command_buffers(const VkCommandBuffer *buffers, const std::uint32_t *image_index)
 {
-    KIT_PERF_SCOPE("lynx::swap_chain::submit_command_buffers")
+    LYNX_TRACE_SCOPE("lynx::swap_chain::submit_command_buffers")
+    if (m_device->null_backend())
+    {
+        m_current_frame = (m_current_frame + 1) % m_config.frames_in_flight;
+        return VK_SUCCESS;
+    }
     if (m_images_in_flight[*image_index] != VK_NULL_HANDLE)
         vkWaitForFences(m_device->vulkan_device(), 1, &m_images_in_flight[*image_index], VK_TRUE, UINT64_MAX);
 
@@ -76,9 +115,10 @@ VkResult swap_chain::submit_command_buffers(const VkCommandBuffer *buffers, cons
     VkSubmitInfo submit_info{};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
+    const bool headless = m_device->headless();
     std::array<VkSemaphore, 1> wait_semaphores = {m_image_available_semaphores[m_current_frame]};
     std::array<VkPipelineStageFlags, 1> wait_stages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submit_info.waitSemaphoreCount = 1;
+    submit_info.waitSemaphoreCount = headless ? 0 : 1;
     submit_info.pWaitSemaphores = wait_semaphores.data();
     submit_info.pWaitDstStageMask = wait_stages.data();
 
@@ -86,13 +126,22 @@ VkResult swap_chain::submit_command_buffers(const VkCommandBuffer *buffers, cons
     submit_info.pCommandBuffers = buffers;
 
     std::array<VkSemaphore, 1> signal_semaphores = {m_render_finished_semaphores[m_current_frame]};
-    submit_info.signalSemaphoreCount = 1;
+    submit_info.signalSemaphoreCount = headless ? 0 : 1;
     submit_info.pSignalSemaphores = signal_semaphores.data();
 
     vkResetFences(m_device->vulkan_device(), 1, &m_in_flight_fences[m_current_frame]);
-    KIT_CHECK_RETURN_VALUE(
-        vkQueueSubmit(m_device->graphics_queue(), 1, &submit_info, m_in_flight_fences[m_current_frame]), VK_SUCCESS,
-        CRITICAL, "Failed to submit draw command buffer")
+    {
+        const auto lock = m_device->lock_queues();
+        KIT_CHECK_RETURN_VALUE(
+            vkQueueSubmit(m_device->graphics_queue(), 1, &submit_info, m_in_flight_fences[m_current_frame]), VK_SUCCESS,
+            CRITICAL, "Failed to submit draw command buffer")
+    }
+
+    if (headless)
+    {
+        m_current_frame = (m_current_frame + 1) % m_config.frames_in_flight;
+        return VK_SUCCESS;
+    }
 
     VkPresentInfoKHR present_info{};
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -105,12 +154,35 @@ VkResult swap_chain::submit_command_buffers(const VkCommandBuffer *buffers, cons
     present_info.pSwapchains = swap_chains.data();
     present_info.pImageIndices = image_index;
 
-    VkResult result = vkQueuePresentKHR(m_device->present_queue(), &present_info);
-    m_current_frame = (m_current_frame + 1) % MAX_FRAMES_IN_FLIGHT;
+    const auto lock = m_device->lock_queues();
+    const VkResult result = vkQueuePresentKHR(m_device->present_queue(), &present_info);
+    m_current_frame = (m_current_frame + 1) % m_config.frames_in_flight;
 
     return result;
 }
 
+// Per frame resources outside the swap chain are shared by the frames submitted with the old ones, so each frame slot
+// waits on the fences of every older swap chain before being reused: with back to back rebuilds, the direct old chain
+// may never have submitted in this slot while an older one still has a frame running in it. The old swap chains are
+// destroyed when all of their frames completed
+void swap_chain::retire_old_swap_chain()
+{
+    for (const swap_chain *old = m_old_swap_chain.get(); old; old = old->m_old_swap_chain.get())
+        if (m_current_frame < old->m_in_flight_fences.size())
+            vkWaitForFences(m_device->vulkan_device(), 1, &old->m_in_flight_fences[m_current_frame], VK_TRUE,
+                            std::numeric_limits<uint64_t>::max());
+    if (m_old_swap_chain->frames_completed())
+        m_old_swap_chain = nullptr;
+}
+
+bool swap_chain::frames_completed() const
+{
+    for (const VkFence fence : m_in_flight_fences)
+        if (vkGetFenceStatus(m_device->vulkan_device(), fence) != VK_SUCCESS)
+            return false;
+    return !m_old_swap_chain || m_old_swap_chain->frames_completed();
+}
+
 bool swap_chain::compare_swap_formats(const swap_chain &swpc) const
 {
     return m_swap_chain_depth_format == swpc.m_swap_chain_depth_format &&
@@ -119,16 +191,17 @@ bool swap_chain::compare_swap_formats(const swap_chain &swpc) const
 
 void swap_chain::init()
 {
+    if (m_device->headless())
+    {
+        create_offscreen_images();
+        return;
+    }
     device::swap_chain_support_details swap_chain_support = m_device->swap_chain_support();
 
     VkSurfaceFormatKHR surface_format = choose_swap_surface_format(swap_chain_support.formats);
-    VkPresentModeKHR present_mode = choose_swap_present_mode(swap_chain_support.present_modes);
+    m_present_mode = choose_swap_present_mode(swap_chain_support.present_modes);
     VkExtent2D extent = choose_swap_extent(swap_chain_support.capabilities);
-
-    std::uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
-    if (swap_chain_support.capabilities.maxImageCount > 0 &&
-        image_count > swap_chain_support.capabilities.maxImageCount)
-        image_count = swap_chain_support.capabilities.maxImageCount;
+    std::uint32_t image_count = choose_image_count(swap_chain_support.capabilities);
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -139,7 +212,13 @@ void swap_chain::init()
     createInfo.imageColorSpace = surface_format.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    // Transfer usages are only needed (and requested when supported) to capture frames and to upscale into the images
+    const VkImageUsageFlags supported = swap_chain_support.capabilities.supportedUsageFlags;
+    m_capturable = supported & VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    m_upscalable = supported & VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                            (m_capturable ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : (VkImageUsageFlags)0) |
+                            (m_upscalable ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : (VkImageUsageFlags)0);
 
     device::queue_family_indices indices = m_device->find_physical_queue_families();
     std::array<std::uint32_t, 2> queue_family_indices = {indices.graphics_family, indices.present_family};
@@ -160,7 +239,7 @@ void swap_chain::init()
     createInfo.preTransform = swap_chain_support.capabilities.currentTransform;
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
 
-    createInfo.presentMode = present_mode;
+    createInfo.presentMode = m_present_mode;
     createInfo.clipped = VK_TRUE;
 
     createInfo.oldSwapchain = m_old_swap_chain ? m_old_swap_chain->m_swap_chain : VK_NULL_HANDLE;
@@ -180,6 +259,55 @@ void swap_chain::init()
     m_extent = extent;
 }
 
+// Mirrors the offscreen layout with placeholder handles so that everything indexing images or frame buffers keeps
+// working, and pipelines can be created against the render pass
+void swap_chain::init_null_backend()
+{
+    m_swap_chain_image_format = VK_FORMAT_B8G8R8A8_UNORM;
+    m_swap_chain_depth_format = find_depth_format();
+    m_extent = m_window_extent;
+    m_render_pass = device::null_handle<VkRenderPass>();
+    m_capturable = false;
+    m_upscalable = false;
+
+    m_swap_chain_images.resize(m_config.frames_in_flight, device::null_handle<VkImage>());
+    m_swap_chain_image_views.resize(m_config.frames_in_flight, device::null_handle<VkImageView>());
+    m_swap_chain_frame_buffers.resize(m_config.frames_in_flight, device::null_handle<VkFramebuffer>());
+}
+
+void swap_chain::create_offscreen_images()
+{
+    KIT_ASSERT_ERROR(m_window_extent.width > 0 && m_window_extent.height > 0,
+                     "Offscreen images must have a non zero extent")
+    m_swap_chain_image_format = VK_FORMAT_B8G8R8A8_UNORM;
+    m_extent = m_window_extent;
+
+    m_swap_chain_images.resize(m_config.frames_in_flight);
+    m_offscreen_image_memories.resize(m_config.frames_in_flight);
+    for (std::size_t i = 0; i < m_swap_chain_images.size(); i++)
+    {
+        VkImageCreateInfo image_info{};
+        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_info.imageType = VK_IMAGE_TYPE_2D;
+        image_info.extent.width = m_extent.width;
+        image_info.extent.height = m_extent.height;
+        image_info.extent.depth = 1;
+        image_info.mipLevels = 1;
+        image_info.arrayLayers = 1;
+        image_info.format = m_swap_chain_image_format;
+        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        image_info.usage =
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_info.flags = 0;
+
+        m_device->create_image_with_info(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_swap_chain_images[i],
+                                         m_offscreen_image_memories[i]);
+    }
+}
+
 void swap_chain::create_image_views()
 {
     m_swap_chain_image_views.resize(m_swap_chain_images.size());
@@ -226,7 +354,8 @@ void swap_chain::create_render_pass()
     color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     color_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color_attachment.finalLayout =
+        m_device->headless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
     VkAttachmentReference color_attachment_ref{};
     color_attachment_ref.attachment = 0;
@@ -240,9 +369,10 @@ void swap_chain::create_render_pass()
 
     VkSubpassDependency dependency{};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.srcAccessMask = 0;
-    dependency.srcStageMask =
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    // The depth image is shared between frames, so the previous frame's depth writes must complete before it is cleared
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                              VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
     dependency.dstSubpass = 0;
     dependency.dstStageMask =
         VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
@@ -267,7 +397,7 @@ void swap_chain::create_frame_buffers()
     m_swap_chain_frame_buffers.resize(m_swap_chain_images.size());
     for (std::size_t i = 0; i < m_swap_chain_images.size(); i++)
     {
-        std::array<VkImageView, 2> attachments = {m_swap_chain_image_views[i], m_depth_image_views[i]};
+        std::array<VkImageView, 2> attachments = {m_swap_chain_image_views[i], m_depth_image_view};
 
         VkFramebufferCreateInfo frame_buffer_info{};
         frame_buffer_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -288,46 +418,40 @@ void swap_chain::create_depth_resources()
 {
     m_swap_chain_depth_format = find_depth_format();
 
-    m_depth_images.resize(m_swap_chain_images.size());
-    m_depth_image_memories.resize(m_swap_chain_images.size());
-    m_depth_image_views.resize(m_swap_chain_images.size());
-
-    for (std::size_t i = 0; i < m_depth_images.size(); i++)
-    {
-        VkImageCreateInfo image_info{};
-        image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-        image_info.imageType = VK_IMAGE_TYPE_2D;
-        image_info.extent.width = m_extent.width;
-        image_info.extent.height = m_extent.height;
-        image_info.extent.depth = 1;
-        image_info.mipLevels = 1;
-        image_info.arrayLayers = 1;
-        image_info.format = m_swap_chain_depth_format;
-        image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-        image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        image_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
-        image_info.samples = VK_SAMPLE_COUNT_1_BIT;
-        image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-        image_info.flags = 0;
-
-        m_device->create_image_with_info(image_info, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depth_images[i],
-                                         m_depth_image_memories[i]);
-
-        VkImageViewCreateInfo view_info{};
-        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        view_info.image = m_depth_images[i];
-        view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        view_info.format = m_swap_chain_depth_format;
-        view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-        view_info.subresourceRange.baseMipLevel = 0;
-        view_info.subresourceRange.levelCount = 1;
-        view_info.subresourceRange.baseArrayLayer = 0;
-        view_info.subresourceRange.layerCount = 1;
-
-        KIT_CHECK_RETURN_VALUE(
-            vkCreateImageView(m_device->vulkan_device(), &view_info, nullptr, &m_depth_image_views[i]), VK_SUCCESS,
-            CRITICAL, "Failed to create texture image view")
-    }
+    VkImageCreateInfo image_info{};
+    image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_info.imageType = VK_IMAGE_TYPE_2D;
+    image_info.extent.width = m_extent.width;
+    image_info.extent.height = m_extent.height;
+    image_info.extent.depth = 1;
+    image_info.mipLevels = 1;
+    image_info.arrayLayers = 1;
+    image_info.format = m_swap_chain_depth_format;
+    image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Depth never leaves the render pass, so tiled GPUs can keep it in on chip memory without backing it
+    image_info.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_info.flags = 0;
+
+    m_device->create_image_with_info(image_info,
+                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                                     m_depth_image, m_depth_image_memory);
+
+    VkImageViewCreateInfo view_info{};
+    view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    view_info.image = m_depth_image;
+    view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    view_info.format = m_swap_chain_depth_format;
+    view_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    view_info.subresourceRange.baseMipLevel = 0;
+    view_info.subresourceRange.levelCount = 1;
+    view_info.subresourceRange.baseArrayLayer = 0;
+    view_info.subresourceRange.layerCount = 1;
+
+    KIT_CHECK_RETURN_VALUE(vkCreateImageView(m_device->vulkan_device(), &view_info, nullptr, &m_depth_image_view),
+                           VK_SUCCESS, CRITICAL, "Failed to create texture image view")
 }
 
 void swap_chain::create_sync_objects()
@@ -341,7 +465,10 @@ void swap_chain::create_sync_objects()
     fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-    for (std::size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    m_image_available_semaphores.resize(m_config.frames_in_flight);
+    m_render_finished_semaphores.resize(m_config.frames_in_flight);
+    m_in_flight_fences.resize(m_config.frames_in_flight);
+    for (std::size_t i = 0; i < m_in_flight_fences.size(); i++)
     {
         KIT_CHECK_RETURN_VALUE(
             vkCreateSemaphore(m_device->vulkan_device(), &semaphore_info, nullptr, &m_image_available_semaphores[i]),
@@ -368,8 +495,18 @@ VkSurfaceFormatKHR swap_chain::choose_swap_surface_format(const std::vector<VkSu
     return available_formats[0];
 }
 
-VkPresentModeKHR swap_chain::choose_swap_present_mode(const std::vector<VkPresentModeKHR> &available_present_modes)
+VkPresentModeKHR swap_chain::choose_swap_present_mode(
+    const std::vector<VkPresentModeKHR> &available_present_modes) const
 {
+    if (m_config.present_mode != VK_PRESENT_MODE_MAX_ENUM_KHR)
+    {
+        for (const auto &available_present_mode : available_present_modes)
+            if (available_present_mode == m_config.present_mode)
+                return available_present_mode;
+        KIT_WARN("The requested present mode is not supported by the surface. Falling back to V-Sync")
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
     for (const auto &available_present_mode : available_present_modes)
         if (available_present_mode == VK_PRESENT_MODE_MAILBOX_KHR)
         {
@@ -387,6 +524,15 @@ VkPresentModeKHR swap_chain::choose_swap_present_mode(const std::vector<VkPresen
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+std::uint32_t swap_chain::choose_image_count(const VkSurfaceCapabilitiesKHR &capabilities) const
+{
+    std::uint32_t image_count = m_config.image_count == 0 ? capabilities.minImageCount + 1 : m_config.image_count;
+    image_count = std::max(image_count, capabilities.minImageCount);
+    if (capabilities.maxImageCount > 0 && image_count > capabilities.maxImageCount)
+        image_count = capabilities.maxImageCount;
+    return image_count;
+}
+
 VkExtent2D swap_chain::choose_swap_extent(const VkSurfaceCapabilitiesKHR &capabilities)
 {
     if (capabilities.currentExtent.width != std::numeric_limits<std::uint32_t>::max())
@@ -416,6 +562,30 @@ VkRenderPass swap_chain::render_pass() const
 {
     return m_render_pass;
 }
+bool swap_chain::capturable() const
+{
+    return m_capturable;
+}
+bool swap_chain::upscalable() const
+{
+    return m_upscalable;
+}
+const swap_chain::config_info &swap_chain::config() const
+{
+    return m_config;
+}
+std::uint32_t swap_chain::frames_in_flight() const
+{
+    return m_config.frames_in_flight;
+}
+VkPresentModeKHR swap_chain::present_mode() const
+{
+    return m_present_mode;
+}
+VkImage swap_chain::image(const std::size_t index) const
+{
+    return m_swap_chain_images[index];
+}
 VkImageView swap_chain::image_view(const std::size_t index) const
 {
     return m_swap_chain_image_views[index];